@@ -0,0 +1,72 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef BENCHMARK_UTILS_HPP
+#define BENCHMARK_UTILS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+namespace xp
+{
+    using benchmark_function = void (*)();
+
+    inline std::vector<std::pair<const char*, benchmark_function>>& get_benchmarks()
+    {
+        static std::vector<std::pair<const char*, benchmark_function>> benchmarks;
+        return benchmarks;
+    }
+
+    struct benchmark_registrar
+    {
+        benchmark_registrar(const char* name, benchmark_function f)
+        {
+            get_benchmarks().emplace_back(name, f);
+        }
+    };
+
+    // Prevents the compiler from optimizing away the computation of v.
+    template <class T>
+    inline void do_not_optimize(const T& v)
+    {
+        volatile T sink = v;
+        static_cast<void>(sink);
+    }
+
+    // Runs f `iterations` times and prints the average time per call.
+    template <class F>
+    inline void measure(const char* name, std::size_t iterations, F&& f)
+    {
+        using clock = std::chrono::steady_clock;
+        auto start = clock::now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            f(i);
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+        double ns_per_op = elapsed / static_cast<double>(iterations);
+        std::printf("  %-48s %10.2f ns/op %12.0f op/s\n", name, ns_per_op, 1e9 / ns_per_op);
+    }
+}
+
+#define XBENCHMARK_CONCAT_IMPL(A, B) A##B
+#define XBENCHMARK_CONCAT(A, B) XBENCHMARK_CONCAT_IMPL(A, B)
+
+// XBENCHMARK(Name)
+// Defines a benchmark function run by the benchmark_xproperty executable.
+
+#define XBENCHMARK(N)                                                                          \
+    static void XBENCHMARK_CONCAT(xbenchmark_, N)();                                           \
+    static ::xp::benchmark_registrar XBENCHMARK_CONCAT(xbenchmark_registrar_, N)(              \
+        #N, &XBENCHMARK_CONCAT(xbenchmark_, N));                                               \
+    static void XBENCHMARK_CONCAT(xbenchmark_, N)()
+
+#endif
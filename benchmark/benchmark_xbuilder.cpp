@@ -0,0 +1,81 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <string>
+
+#include "benchmark_utils.hpp"
+
+#include "xproperty/xobserved.hpp"
+
+namespace
+{
+    struct Widget : xp::xobserved<Widget>
+    {
+        Widget()
+        {
+            Widget& self = *this;
+            XVALIDATE(self, width, [](Widget&, double& proposal) { if (proposal < 0.0) proposal = 0.0; });
+            XOBSERVE(self, width, [](Widget& w) { w.layout = w.width(); });
+        }
+
+        XPROPERTY(double, Widget, width);
+        XPROPERTY(double, Widget, height);
+        XPROPERTY(int, Widget, index);
+        XPROPERTY(bool, Widget, visible);
+        XPROPERTY(std::string, Widget, description);
+
+        double layout = 0.0;
+    };
+
+    constexpr std::size_t iterations = 200000;
+}
+
+XBENCHMARK(builder)
+{
+    xp::measure("plain assignment", iterations, [](std::size_t i) {
+        Widget w;
+        w.width = static_cast<double>(i);
+        w.height = 2.0;
+        w.index = 3;
+        w.visible = true;
+        w.description = "widget";
+        xp::do_not_optimize(w.layout);
+    });
+
+    xp::measure("chained setters", iterations, [](std::size_t i) {
+        Widget w = Widget()
+            .width(static_cast<double>(i))
+            .height(2.0)
+            .index(3)
+            .visible(true)
+            .description("widget");
+        xp::do_not_optimize(w.width());
+    });
+
+    xp::measure("xbuilder", iterations, [](std::size_t i) {
+        Widget w = xp::xbuilder<Widget>()
+            .set(&Widget::width, static_cast<double>(i))
+            .set(&Widget::height, 2.0)
+            .set(&Widget::index, 3)
+            .set(&Widget::visible, true)
+            .set(&Widget::description, "widget")
+            .build();
+        xp::do_not_optimize(w.width());
+    });
+
+    xp::measure("xbuilder, in place", iterations, [](std::size_t i) {
+        xp::xbuilder<Widget> builder;
+        builder.set(&Widget::width, static_cast<double>(i))
+               .set(&Widget::height, 2.0)
+               .set(&Widget::index, 3)
+               .set(&Widget::visible, true)
+               .set(&Widget::description, "widget");
+        xp::do_not_optimize(builder.get().width());
+    });
+}
@@ -0,0 +1,44 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+
+#include "benchmark_utils.hpp"
+
+#include "xproperty/xobserved.hpp"
+
+namespace
+{
+    struct Linked : xp::xobserved<Linked>
+    {
+        XPROPERTY(double, Linked, value);
+    };
+
+    constexpr std::size_t iterations = 1000000;
+}
+
+XBENCHMARK(link)
+{
+    {
+        Linked source, target;
+        XOBSERVE(source, value, [&target](Linked& s) { target.value = s.value(); });
+        xp::measure("observer propagation", iterations, [&](std::size_t i) {
+            source.value = static_cast<double>(i);
+        });
+        xp::do_not_optimize(target.value());
+    }
+
+    {
+        Linked source, target;
+        XDLINK(source, value, target, value);
+        xp::measure("XDLINK propagation", iterations, [&](std::size_t i) {
+            source.value = static_cast<double>(i);
+        });
+        xp::do_not_optimize(target.value());
+    }
+}
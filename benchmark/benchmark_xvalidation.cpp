@@ -0,0 +1,86 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <stdexcept>
+
+#include "benchmark_utils.hpp"
+
+#include "xproperty/xobserved.hpp"
+
+namespace
+{
+    struct Validated : xp::xobserved<Validated>
+    {
+        XPROPERTY(double, Validated, value);
+    };
+
+    constexpr std::size_t iterations = 1000000;
+
+    // Every other proposal is negative and rejected.
+    double proposal(std::size_t i)
+    {
+        return (i % 2 == 0) ? -1.0 : static_cast<double>(i);
+    }
+}
+
+XBENCHMARK(validation)
+{
+    {
+        Validated v;
+        XVALIDATE(v, value, [](Validated&, double& proposal) {
+            if (proposal < 0.0)
+            {
+                throw std::runtime_error("Only non-negative values are valid.");
+            }
+        });
+
+        std::size_t rejected = 0;
+        xp::measure("throwing validator, operator=", iterations, [&](std::size_t i) {
+            try
+            {
+                v.value = proposal(i);
+            }
+            catch (std::runtime_error&)
+            {
+                ++rejected;
+            }
+        });
+        xp::do_not_optimize(rejected);
+    }
+
+    {
+        Validated v;
+        XVALIDATE(v, value, [](Validated&, double& proposal) {
+            return proposal < 0.0 ? xp::xvalidation::reject("Only non-negative values are valid.")
+                                  : xp::xvalidation::accept();
+        });
+
+        std::size_t rejected = 0;
+        xp::measure("status validator, operator=", iterations, [&](std::size_t i) {
+            try
+            {
+                v.value = proposal(i);
+            }
+            catch (xp::xvalidation_error&)
+            {
+                ++rejected;
+            }
+        });
+        xp::do_not_optimize(rejected);
+
+        rejected = 0;
+        xp::measure("status validator, try_assign", iterations, [&](std::size_t i) {
+            if (!v.value.try_assign(proposal(i)))
+            {
+                ++rejected;
+            }
+        });
+        xp::do_not_optimize(rejected);
+    }
+}
@@ -0,0 +1,50 @@
+############################################################################
+# Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     #
+#                                                                          #
+# Distributed under the terms of the BSD 3-Clause License.                 #
+#                                                                          #
+# The full license is in the file LICENSE, distributed with this software. #
+############################################################################
+
+# Generates a synthetic model of xobserved classes with PROPERTIES properties
+# in total, PROPERTIES_PER_CLASS per class, into OUTPUT.
+
+set(types "double" "int" "bool" "std::string" "std::vector<double>")
+set(values "1.0" "1" "true" "\"value\"" "std::vector<double>(1u, 1.0)")
+list(LENGTH types type_count)
+
+math(EXPR class_count "(${PROPERTIES} + ${PROPERTIES_PER_CLASS} - 1) / ${PROPERTIES_PER_CLASS}")
+math(EXPR last_class "${class_count} - 1")
+
+set(content "// Generated by generate_model.cmake, do not edit.\n\n")
+string(APPEND content "#include <string>\n#include <vector>\n\n#include \"xproperty/xobserved.hpp\"\n\n")
+string(APPEND content "namespace codesize\n{\n")
+
+set(property 0)
+foreach(c RANGE ${last_class})
+    string(APPEND content "    struct model${c} : xp::xobserved<model${c}>\n    {\n")
+    set(assignments "")
+    foreach(p RANGE 1 ${PROPERTIES_PER_CLASS})
+        if(property LESS PROPERTIES)
+            math(EXPR t "${property} % ${type_count}")
+            list(GET types ${t} type)
+            list(GET values ${t} value)
+            string(APPEND content "        XPROPERTY(${type}, model${c}, p${property});\n")
+            string(APPEND assignments "        m.p${property} = ${value};\n")
+            math(EXPR property "${property} + 1")
+        endif()
+    endforeach()
+    string(APPEND content "    };\n\n")
+    string(APPEND content "    void use_model${c}()\n    {\n        model${c} m;\n")
+    string(APPEND content "        m.observe(\"p\", [](model${c}&) {});\n")
+    string(APPEND content "${assignments}    }\n\n")
+endforeach()
+
+string(APPEND content "}\n\nvoid use_codesize_model()\n{\n")
+foreach(c RANGE ${last_class})
+    string(APPEND content "    codesize::use_model${c}();\n")
+endforeach()
+string(APPEND content "}\n")
+
+file(WRITE "${OUTPUT}.tmp" "${content}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different "${OUTPUT}.tmp" "${OUTPUT}")
@@ -0,0 +1,42 @@
+############################################################################
+# Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     #
+#                                                                          #
+# Distributed under the terms of the BSD 3-Clause License.                 #
+#                                                                          #
+# The full license is in the file LICENSE, distributed with this software. #
+############################################################################
+
+# Reports the size of the code sections of the OBJECT file compiled from the
+# synthetic model, as listed by the SIZE tool in System V format, and fails if
+# it exceeds LIMIT bytes (no limit if LIMIT is 0). The size of the object file
+# also counts its symbols and debug information, it is only reported.
+
+file(SIZE "${OBJECT}" object_size)
+
+if(NOT SIZE_TOOL)
+    message(STATUS "xproperty code size: ${object_size} bytes of object file for ${PROPERTIES} properties")
+    message(WARNING "No size tool found, the code size limit is not checked")
+    return()
+endif()
+
+execute_process(COMMAND "${SIZE_TOOL}" -A "${OBJECT}"
+                OUTPUT_VARIABLE sections
+                RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${SIZE_TOOL} failed on ${OBJECT}")
+endif()
+
+# Sums .text and the .text.* sections of inline functions (__text on macOS)
+set(text_size 0)
+string(REPLACE "\n" ";" sections "${sections}")
+foreach(section IN LISTS sections)
+    if(section MATCHES "^(\\.text|__text)[^ \t]*[ \t]+([0-9]+)")
+        math(EXPR text_size "${text_size} + ${CMAKE_MATCH_2}")
+    endif()
+endforeach()
+
+message(STATUS "xproperty code size: ${text_size} bytes of code, ${object_size} bytes of object file for ${PROPERTIES} properties")
+
+if(LIMIT GREATER 0 AND text_size GREATER LIMIT)
+    message(FATAL_ERROR "xproperty code size regression: ${text_size} bytes of code exceed the limit of ${LIMIT} bytes")
+endif()
@@ -0,0 +1,27 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+
+#include "benchmark_utils.hpp"
+
+int main(int argc, char* argv[])
+{
+    // An optional argument restricts the run to benchmarks whose name contains it.
+    const char* filter = argc > 1 ? argv[1] : "";
+    for (const auto& benchmark : xp::get_benchmarks())
+    {
+        if (std::strstr(benchmark.first, filter) != nullptr)
+        {
+            std::printf("%s\n", benchmark.first);
+            benchmark.second();
+        }
+    }
+    return 0;
+}
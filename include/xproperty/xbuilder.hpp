@@ -0,0 +1,118 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XPROPERTY_BUILDER_HPP
+#define XPROPERTY_BUILDER_HPP
+
+#include <type_traits>
+#include <utility>
+
+namespace xp
+{
+
+    /************************
+     * xbuilder declaration *
+     ************************/
+
+    // Initializes the properties of an xobserved object in place:
+    //
+    //     Foo foo = xp::xbuilder<Foo>().set(&Foo::bar, 1.0).set(&Foo::baz, 2.0).build();
+    //
+    // The validators of a property are invoked once per call to set, and
+    // a rejection throws xvalidation_error. Observers are not invoked, changes
+    // are not recorded and links are not propagated. Unlike the chained setters
+    // of xproperty, which move the owner at each call, the object is only moved
+    // by build.
+
+    template <class D>
+    class xbuilder
+    {
+    public:
+
+        using owner_type = D;
+
+        template <class... Args>
+        explicit xbuilder(Args&&... args);
+
+        xbuilder(const xbuilder&) = delete;
+        xbuilder& operator=(const xbuilder&) = delete;
+
+        template <class M, class... Args>
+        xbuilder& set(M property, Args&&... args) &;
+
+        template <class M, class... Args>
+        xbuilder&& set(M property, Args&&... args) &&;
+
+        owner_type& get() noexcept;
+        owner_type build() &&;
+
+    private:
+
+        template <class M, class... Args>
+        void set_value(M property, Args&&... args);
+
+        owner_type m_owner;
+    };
+
+    /***************************
+     * xbuilder implementation *
+     ***************************/
+
+    template <class D>
+    template <class... Args>
+    inline xbuilder<D>::xbuilder(Args&&... args)
+        : m_owner(std::forward<Args>(args)...)
+    {
+    }
+
+    /**
+     * Sets the value of the property pointed to by the pointer to member
+     * property, constructed from args.
+     */
+    template <class D>
+    template <class M, class... Args>
+    inline auto xbuilder<D>::set(M property, Args&&... args) & -> xbuilder&
+    {
+        set_value(property, std::forward<Args>(args)...);
+        return *this;
+    }
+
+    template <class D>
+    template <class M, class... Args>
+    inline auto xbuilder<D>::set(M property, Args&&... args) && -> xbuilder&&
+    {
+        set_value(property, std::forward<Args>(args)...);
+        return std::move(*this);
+    }
+
+    /**
+     * Returns the object being built, to use it in place.
+     */
+    template <class D>
+    inline auto xbuilder<D>::get() noexcept -> owner_type&
+    {
+        return m_owner;
+    }
+
+    template <class D>
+    inline auto xbuilder<D>::build() && -> owner_type
+    {
+        return std::move(m_owner);
+    }
+
+    template <class D>
+    template <class M, class... Args>
+    inline void xbuilder<D>::set_value(M property, Args&&... args)
+    {
+        auto& p = m_owner.*property;
+        typename std::decay_t<decltype(p)>::value_type proposal(std::forward<Args>(args)...);
+        p.initialize(proposal);
+    }
+}
+
+#endif
@@ -0,0 +1,298 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XPROPERTY_CHANGE_BUFFER_HPP
+#define XPROPERTY_CHANGE_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace xp
+{
+
+    /*****************************
+     * xchange_record definition *
+     *****************************/
+
+    // Change of the property of index `index` in an xchange_buffer. Records
+    // of a buffer whose value type is not void also hold the previous and the
+    // new values of the property.
+
+    template <class V>
+    struct xchange_record
+    {
+        std::size_t index;
+        std::uint64_t sequence;
+        V old_value;
+        V new_value;
+    };
+
+    template <>
+    struct xchange_record<void>
+    {
+        std::size_t index;
+        std::uint64_t sequence;
+    };
+
+    // Behavior of a full xchange_buffer:
+    //  - report: the change is dropped and counted in `dropped()`. Its
+    //    sequence number is still consumed, so that consumers can detect
+    //    the gap.
+    //  - coalesce: the change is merged into the pending record of the same
+    //    property, which keeps its old value, its position and its sequence
+    //    number. The merged change does not consume a sequence number, so
+    //    that gaps still denote drops. If there is no pending record, the
+    //    change is dropped as with `report`.
+
+    enum class xoverflow_policy
+    {
+        report,
+        coalesce
+    };
+
+    /******************************
+     * xchange_buffer declaration *
+     ******************************/
+
+    // Bounded ring buffer of change records fed by the properties of xobserved
+    // objects, see XRECORD. Storage is allocated upon construction and upon
+    // registration of properties: recording a change does not allocate as long
+    // as copying a V does not. Recording and draining are synchronized, so that
+    // changes can be drained from another thread.
+
+    template <class V = void>
+    class xchange_buffer
+    {
+    public:
+
+        using value_type = V;
+        using record_type = xchange_record<V>;
+        using size_type = std::size_t;
+
+        static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+        explicit xchange_buffer(size_type capacity, xoverflow_policy policy = xoverflow_policy::report);
+
+        xchange_buffer(const xchange_buffer&) = delete;
+        xchange_buffer& operator=(const xchange_buffer&) = delete;
+
+        size_type capacity() const noexcept;
+        xoverflow_policy policy() const noexcept;
+
+        size_type size() const;
+        bool empty() const;
+        size_type dropped() const;
+
+        size_type register_property(const char* name, const void* key = nullptr);
+        const char* name(size_type index) const;
+        const void* key(size_type index) const;
+
+        template <class F>
+        size_type drain(F&& f, size_type max_count = npos);
+
+        void push(size_type index);
+        template <class OV, class NV>
+        void push(size_type index, OV&& old_value, NV&& new_value);
+
+    private:
+
+        record_type* acquire(size_type index, bool& coalesced);
+
+        std::vector<record_type> m_records;
+        std::vector<size_type> m_pending;
+        std::vector<const char*> m_names;
+        std::vector<const void*> m_keys;
+        size_type m_head;
+        size_type m_size;
+        size_type m_dropped;
+        std::uint64_t m_sequence;
+        xoverflow_policy m_policy;
+        mutable std::mutex m_mutex;
+    };
+
+    /*********************************
+     * xchange_buffer implementation *
+     *********************************/
+
+    template <class V>
+    inline xchange_buffer<V>::xchange_buffer(size_type capacity, xoverflow_policy policy)
+        : m_records(capacity)
+        , m_head(0u)
+        , m_size(0u)
+        , m_dropped(0u)
+        , m_sequence(0u)
+        , m_policy(policy)
+    {
+    }
+
+    template <class V>
+    inline auto xchange_buffer<V>::capacity() const noexcept -> size_type
+    {
+        return m_records.size();
+    }
+
+    template <class V>
+    inline xoverflow_policy xchange_buffer<V>::policy() const noexcept
+    {
+        return m_policy;
+    }
+
+    template <class V>
+    inline auto xchange_buffer<V>::size() const -> size_type
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_size;
+    }
+
+    template <class V>
+    inline bool xchange_buffer<V>::empty() const
+    {
+        return size() == 0u;
+    }
+
+    /**
+     * Returns the number of changes dropped because the buffer was full.
+     */
+    template <class V>
+    inline auto xchange_buffer<V>::dropped() const -> size_type
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_dropped;
+    }
+
+    /**
+     * Registers a property recording its changes in the buffer and returns
+     * the index identifying it in the records. key identifies the owner of
+     * the property, so that a buffer can be shared by several owners.
+     */
+    template <class V>
+    inline auto xchange_buffer<V>::register_property(const char* name, const void* key) -> size_type
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_names.push_back(name);
+        m_keys.push_back(key);
+        m_pending.push_back(npos);
+        return m_names.size() - 1u;
+    }
+
+    template <class V>
+    inline const char* xchange_buffer<V>::name(size_type index) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_names[index];
+    }
+
+    /**
+     * Returns the key of the owner of the property of the specified index.
+     */
+    template <class V>
+    inline const void* xchange_buffer<V>::key(size_type index) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_keys[index];
+    }
+
+    /**
+     * Removes at most max_count records from the buffer, oldest first, and
+     * calls f on each of them. The records are moved out of the buffer before
+     * f is called, so that f can use the buffer, or change recorded properties.
+     * @return the number of drained records.
+     */
+    template <class V>
+    template <class F>
+    inline auto xchange_buffer<V>::drain(F&& f, size_type max_count) -> size_type
+    {
+        std::vector<record_type> drained;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            size_type count = m_size < max_count ? m_size : max_count;
+            drained.reserve(count);
+            for (size_type i = 0; i < count; ++i)
+            {
+                record_type& record = m_records[m_head];
+                if (m_pending[record.index] == m_head)
+                {
+                    m_pending[record.index] = npos;
+                }
+                drained.push_back(std::move(record));
+                m_head = m_head + 1u == m_records.size() ? 0u : m_head + 1u;
+            }
+            m_size -= count;
+        }
+        for (const record_type& record : drained)
+        {
+            f(record);
+        }
+        return drained.size();
+    }
+
+    template <class V>
+    inline void xchange_buffer<V>::push(size_type index)
+    {
+        static_assert(std::is_void<V>::value, "records hold the old and the new values of the property");
+        std::lock_guard<std::mutex> lock(m_mutex);
+        bool coalesced = false;
+        acquire(index, coalesced);
+    }
+
+    template <class V>
+    template <class OV, class NV>
+    inline void xchange_buffer<V>::push(size_type index, OV&& old_value, NV&& new_value)
+    {
+        static_assert(!std::is_void<V>::value, "records do not hold values");
+        std::lock_guard<std::mutex> lock(m_mutex);
+        bool coalesced = false;
+        record_type* record = acquire(index, coalesced);
+        if (record != nullptr)
+        {
+            if (!coalesced)
+            {
+                record->old_value = std::forward<OV>(old_value);
+            }
+            record->new_value = std::forward<NV>(new_value);
+        }
+    }
+
+    // Returns the record to fill for a change of the specified property, or
+    // nullptr if the change is dropped. Must be called with the mutex locked.
+    template <class V>
+    inline auto xchange_buffer<V>::acquire(size_type index, bool& coalesced) -> record_type*
+    {
+        if (m_size == m_records.size())
+        {
+            size_type pending = m_pending[index];
+            if (m_policy == xoverflow_policy::coalesce && pending != npos)
+            {
+                coalesced = true;
+                return &m_records[pending];
+            }
+            ++m_sequence;
+            ++m_dropped;
+            return nullptr;
+        }
+
+        size_type pos = m_head + m_size;
+        if (pos >= m_records.size())
+        {
+            pos -= m_records.size();
+        }
+        record_type* record = &m_records[pos];
+        record->index = index;
+        record->sequence = m_sequence++;
+        m_pending[index] = pos;
+        ++m_size;
+        return record;
+    }
+}
+
+#endif
@@ -0,0 +1,856 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XPROPERTY_CONTAINERS_HPP
+#define XPROPERTY_CONTAINERS_HPP
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "xproperty.hpp"
+
+namespace xp
+{
+
+    /*********************************
+     * container events and bindings *
+     *********************************/
+
+    enum class xcontainer_op
+    {
+        insert,
+        erase,
+        replace,
+        clear,
+        assign
+    };
+
+    // Change of an xobservable_vector: `count` elements inserted at, erased
+    // from, or replaced at `index`. Inserted and replaced elements can be read
+    // from `container`. An assign event replaces the whole content, of which
+    // `count` is the size.
+
+    template <class C>
+    struct xvector_event
+    {
+        using container_type = C;
+        using size_type = typename C::size_type;
+
+        xcontainer_op op;
+        size_type index;
+        size_type count;
+        const container_type& container;
+    };
+
+    // Change of an xobservable_map: the element of the specified key was
+    // inserted, erased or replaced. `key` is null for clear and assign, which
+    // replaces the whole content.
+
+    template <class C>
+    struct xmap_event
+    {
+        using container_type = C;
+        using key_type = typename C::key_type;
+
+        xcontainer_op op;
+        const key_type* key;
+        const container_type& container;
+    };
+
+    // Connects an observable container to the xobserved owning its property.
+    // Copying a container does not copy its binding: a copy is only bound when
+    // it is the value of a property, and assigning to a container keeps its
+    // own binding.
+
+    template <class E>
+    class xcontainer_binding
+    {
+    public:
+
+        using event_type = E;
+        using callback_type = void (*)(void*, const char*, const event_type&);
+
+        xcontainer_binding() = default;
+        ~xcontainer_binding() = default;
+
+        xcontainer_binding(const xcontainer_binding&) noexcept;
+        xcontainer_binding& operator=(const xcontainer_binding&) noexcept;
+
+        void bind(void* owner, const char* name, callback_type callback) noexcept;
+        void operator()(const event_type& event) const;
+
+    private:
+
+        void* p_owner = nullptr;
+        const char* m_name = nullptr;
+        callback_type m_callback = nullptr;
+    };
+
+    /**********************************
+     * xobservable_vector declaration *
+     **********************************/
+
+    // A std::vector emitting an xvector_event on each modification when it is
+    // the value of a property. Elements are only accessible for reading, and
+    // are modified through the set, insert and erase methods.
+
+    template <class T, class A = std::allocator<T>>
+    class xobservable_vector
+    {
+    public:
+
+        using container_type = std::vector<T, A>;
+        using value_type = typename container_type::value_type;
+        using allocator_type = typename container_type::allocator_type;
+        using size_type = typename container_type::size_type;
+        using difference_type = typename container_type::difference_type;
+        using const_reference = typename container_type::const_reference;
+        using const_pointer = typename container_type::const_pointer;
+        using const_iterator = typename container_type::const_iterator;
+        using const_reverse_iterator = typename container_type::const_reverse_iterator;
+        using event_type = xvector_event<xobservable_vector>;
+
+        xobservable_vector() = default;
+        xobservable_vector(std::initializer_list<value_type> init);
+        xobservable_vector(size_type count, const value_type& value);
+        explicit xobservable_vector(size_type count);
+        template <class It>
+        xobservable_vector(It first, It last);
+        explicit xobservable_vector(const container_type& data);
+        explicit xobservable_vector(container_type&& data) noexcept;
+
+        const container_type& value() const noexcept;
+        operator const container_type&() const noexcept;
+
+        const_reference operator[](size_type pos) const;
+        const_reference at(size_type pos) const;
+        const_reference front() const;
+        const_reference back() const;
+        const_pointer data() const noexcept;
+
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+        const_reverse_iterator rbegin() const noexcept;
+        const_reverse_iterator rend() const noexcept;
+
+        bool empty() const noexcept;
+        size_type size() const noexcept;
+        size_type capacity() const noexcept;
+        void reserve(size_type new_cap);
+
+        template <class V>
+        void set(size_type pos, V&& value);
+
+        void push_back(const value_type& value);
+        void push_back(value_type&& value);
+        template <class... Args>
+        const_reference emplace_back(Args&&... args);
+        void pop_back();
+
+        const_iterator insert(const_iterator pos, const value_type& value);
+        const_iterator insert(const_iterator pos, value_type&& value);
+        const_iterator insert(const_iterator pos, size_type count, const value_type& value);
+        template <class It>
+        const_iterator insert(const_iterator pos, It first, It last);
+        const_iterator insert(const_iterator pos, std::initializer_list<value_type> init);
+        template <class... Args>
+        const_iterator emplace(const_iterator pos, Args&&... args);
+
+        const_iterator erase(const_iterator pos);
+        const_iterator erase(const_iterator first, const_iterator last);
+        void clear();
+
+        void resize(size_type count);
+        void resize(size_type count, const value_type& value);
+
+        void assign(container_type data);
+
+    private:
+
+        event_type assign_event() const noexcept;
+        void emit(xcontainer_op op, size_type index, size_type count) const;
+        const_iterator emit_insert(const_iterator pos, size_type old_size);
+
+        container_type m_data;
+        xcontainer_binding<event_type> m_binding;
+
+        template <class X, class Y>
+        friend class xproperty;
+    };
+
+    template <class T, class A>
+    bool operator==(const xobservable_vector<T, A>& lhs, const xobservable_vector<T, A>& rhs);
+
+    template <class T, class A>
+    bool operator!=(const xobservable_vector<T, A>& lhs, const xobservable_vector<T, A>& rhs);
+
+    /*******************************
+     * xobservable_map declaration *
+     *******************************/
+
+    // A std::map emitting an xmap_event on each modification when it is the
+    // value of a property. Mapped values are only accessible for reading, and
+    // are modified through the insert_or_assign and erase methods.
+
+    template <class K, class V, class C = std::less<K>, class A = std::allocator<std::pair<const K, V>>>
+    class xobservable_map
+    {
+    public:
+
+        using container_type = std::map<K, V, C, A>;
+        using key_type = typename container_type::key_type;
+        using mapped_type = typename container_type::mapped_type;
+        using value_type = typename container_type::value_type;
+        using key_compare = typename container_type::key_compare;
+        using allocator_type = typename container_type::allocator_type;
+        using size_type = typename container_type::size_type;
+        using difference_type = typename container_type::difference_type;
+        using const_reference = typename container_type::const_reference;
+        using const_iterator = typename container_type::const_iterator;
+        using const_reverse_iterator = typename container_type::const_reverse_iterator;
+        using event_type = xmap_event<xobservable_map>;
+
+        xobservable_map() = default;
+        xobservable_map(std::initializer_list<value_type> init);
+        template <class It>
+        xobservable_map(It first, It last);
+        explicit xobservable_map(const container_type& data);
+        explicit xobservable_map(container_type&& data) noexcept;
+
+        const container_type& value() const noexcept;
+        operator const container_type&() const noexcept;
+
+        const mapped_type& at(const key_type& key) const;
+        const_iterator find(const key_type& key) const;
+        size_type count(const key_type& key) const;
+
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+        const_reverse_iterator rbegin() const noexcept;
+        const_reverse_iterator rend() const noexcept;
+
+        bool empty() const noexcept;
+        size_type size() const noexcept;
+
+        template <class M>
+        std::pair<const_iterator, bool> insert_or_assign(const key_type& key, M&& value);
+        std::pair<const_iterator, bool> insert(const value_type& value);
+        std::pair<const_iterator, bool> insert(value_type&& value);
+        template <class... Args>
+        std::pair<const_iterator, bool> emplace(Args&&... args);
+
+        const_iterator erase(const_iterator pos);
+        size_type erase(const key_type& key);
+        void clear();
+
+        void assign(container_type data);
+
+    private:
+
+        event_type assign_event() const noexcept;
+        void emit(xcontainer_op op, const key_type* key) const;
+        std::pair<const_iterator, bool> emit_insert(std::pair<typename container_type::iterator, bool> res);
+
+        container_type m_data;
+        xcontainer_binding<event_type> m_binding;
+
+        template <class X, class Y>
+        friend class xproperty;
+    };
+
+    template <class K, class V, class C, class A>
+    bool operator==(const xobservable_map<K, V, C, A>& lhs, const xobservable_map<K, V, C, A>& rhs);
+
+    template <class K, class V, class C, class A>
+    bool operator!=(const xobservable_map<K, V, C, A>& lhs, const xobservable_map<K, V, C, A>& rhs);
+
+    template <class T, class A>
+    struct is_xobservable_container<xobservable_vector<T, A>> : std::true_type
+    {
+    };
+
+    template <class K, class V, class C, class A>
+    struct is_xobservable_container<xobservable_map<K, V, C, A>> : std::true_type
+    {
+    };
+
+    /*************************************
+     * xcontainer_binding implementation *
+     *************************************/
+
+    template <class E>
+    inline xcontainer_binding<E>::xcontainer_binding(const xcontainer_binding&) noexcept
+    {
+    }
+
+    template <class E>
+    inline auto xcontainer_binding<E>::operator=(const xcontainer_binding&) noexcept -> xcontainer_binding&
+    {
+        return *this;
+    }
+
+    template <class E>
+    inline void xcontainer_binding<E>::bind(void* owner, const char* name, callback_type callback) noexcept
+    {
+        p_owner = owner;
+        m_name = name;
+        m_callback = callback;
+    }
+
+    template <class E>
+    inline void xcontainer_binding<E>::operator()(const event_type& event) const
+    {
+        if (m_callback != nullptr)
+        {
+            m_callback(p_owner, m_name, event);
+        }
+    }
+
+    /*************************************
+     * xobservable_vector implementation *
+     *************************************/
+
+    template <class T, class A>
+    inline xobservable_vector<T, A>::xobservable_vector(std::initializer_list<value_type> init)
+        : m_data(init)
+    {
+    }
+
+    template <class T, class A>
+    inline xobservable_vector<T, A>::xobservable_vector(size_type count, const value_type& value)
+        : m_data(count, value)
+    {
+    }
+
+    template <class T, class A>
+    inline xobservable_vector<T, A>::xobservable_vector(size_type count)
+        : m_data(count)
+    {
+    }
+
+    template <class T, class A>
+    template <class It>
+    inline xobservable_vector<T, A>::xobservable_vector(It first, It last)
+        : m_data(first, last)
+    {
+    }
+
+    template <class T, class A>
+    inline xobservable_vector<T, A>::xobservable_vector(const container_type& data)
+        : m_data(data)
+    {
+    }
+
+    template <class T, class A>
+    inline xobservable_vector<T, A>::xobservable_vector(container_type&& data) noexcept
+        : m_data(std::move(data))
+    {
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::value() const noexcept -> const container_type&
+    {
+        return m_data;
+    }
+
+    template <class T, class A>
+    inline xobservable_vector<T, A>::operator const container_type&() const noexcept
+    {
+        return m_data;
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::operator[](size_type pos) const -> const_reference
+    {
+        return m_data[pos];
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::at(size_type pos) const -> const_reference
+    {
+        return m_data.at(pos);
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::front() const -> const_reference
+    {
+        return m_data.front();
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::back() const -> const_reference
+    {
+        return m_data.back();
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::data() const noexcept -> const_pointer
+    {
+        return m_data.data();
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::begin() const noexcept -> const_iterator
+    {
+        return m_data.begin();
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::end() const noexcept -> const_iterator
+    {
+        return m_data.end();
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::cbegin() const noexcept -> const_iterator
+    {
+        return m_data.cbegin();
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::cend() const noexcept -> const_iterator
+    {
+        return m_data.cend();
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::rbegin() const noexcept -> const_reverse_iterator
+    {
+        return m_data.rbegin();
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::rend() const noexcept -> const_reverse_iterator
+    {
+        return m_data.rend();
+    }
+
+    template <class T, class A>
+    inline bool xobservable_vector<T, A>::empty() const noexcept
+    {
+        return m_data.empty();
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::size() const noexcept -> size_type
+    {
+        return m_data.size();
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::capacity() const noexcept -> size_type
+    {
+        return m_data.capacity();
+    }
+
+    template <class T, class A>
+    inline void xobservable_vector<T, A>::reserve(size_type new_cap)
+    {
+        m_data.reserve(new_cap);
+    }
+
+    template <class T, class A>
+    template <class V>
+    inline void xobservable_vector<T, A>::set(size_type pos, V&& value)
+    {
+        m_data.at(pos) = std::forward<V>(value);
+        emit(xcontainer_op::replace, pos, 1u);
+    }
+
+    template <class T, class A>
+    inline void xobservable_vector<T, A>::push_back(const value_type& value)
+    {
+        m_data.push_back(value);
+        emit(xcontainer_op::insert, m_data.size() - 1u, 1u);
+    }
+
+    template <class T, class A>
+    inline void xobservable_vector<T, A>::push_back(value_type&& value)
+    {
+        m_data.push_back(std::move(value));
+        emit(xcontainer_op::insert, m_data.size() - 1u, 1u);
+    }
+
+    template <class T, class A>
+    template <class... Args>
+    inline auto xobservable_vector<T, A>::emplace_back(Args&&... args) -> const_reference
+    {
+        m_data.emplace_back(std::forward<Args>(args)...);
+        emit(xcontainer_op::insert, m_data.size() - 1u, 1u);
+        return m_data.back();
+    }
+
+    template <class T, class A>
+    inline void xobservable_vector<T, A>::pop_back()
+    {
+        m_data.pop_back();
+        emit(xcontainer_op::erase, m_data.size(), 1u);
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::insert(const_iterator pos, const value_type& value) -> const_iterator
+    {
+        auto it = m_data.insert(pos, value);
+        emit(xcontainer_op::insert, static_cast<size_type>(it - m_data.begin()), 1u);
+        return it;
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::insert(const_iterator pos, value_type&& value) -> const_iterator
+    {
+        auto it = m_data.insert(pos, std::move(value));
+        emit(xcontainer_op::insert, static_cast<size_type>(it - m_data.begin()), 1u);
+        return it;
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::insert(const_iterator pos, size_type count, const value_type& value) -> const_iterator
+    {
+        size_type old_size = m_data.size();
+        return emit_insert(m_data.insert(pos, count, value), old_size);
+    }
+
+    template <class T, class A>
+    template <class It>
+    inline auto xobservable_vector<T, A>::insert(const_iterator pos, It first, It last) -> const_iterator
+    {
+        size_type old_size = m_data.size();
+        return emit_insert(m_data.insert(pos, first, last), old_size);
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::insert(const_iterator pos, std::initializer_list<value_type> init) -> const_iterator
+    {
+        size_type old_size = m_data.size();
+        return emit_insert(m_data.insert(pos, init), old_size);
+    }
+
+    template <class T, class A>
+    template <class... Args>
+    inline auto xobservable_vector<T, A>::emplace(const_iterator pos, Args&&... args) -> const_iterator
+    {
+        auto it = m_data.emplace(pos, std::forward<Args>(args)...);
+        emit(xcontainer_op::insert, static_cast<size_type>(it - m_data.begin()), 1u);
+        return it;
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::erase(const_iterator pos) -> const_iterator
+    {
+        auto it = m_data.erase(pos);
+        emit(xcontainer_op::erase, static_cast<size_type>(it - m_data.begin()), 1u);
+        return it;
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::erase(const_iterator first, const_iterator last) -> const_iterator
+    {
+        size_type count = static_cast<size_type>(last - first);
+        auto it = m_data.erase(first, last);
+        if (count != 0u)
+        {
+            emit(xcontainer_op::erase, static_cast<size_type>(it - m_data.begin()), count);
+        }
+        return it;
+    }
+
+    template <class T, class A>
+    inline void xobservable_vector<T, A>::clear()
+    {
+        size_type count = m_data.size();
+        m_data.clear();
+        emit(xcontainer_op::clear, 0u, count);
+    }
+
+    template <class T, class A>
+    inline void xobservable_vector<T, A>::resize(size_type count)
+    {
+        resize(count, value_type());
+    }
+
+    template <class T, class A>
+    inline void xobservable_vector<T, A>::resize(size_type count, const value_type& value)
+    {
+        size_type old_size = m_data.size();
+        m_data.resize(count, value);
+        if (count > old_size)
+        {
+            emit(xcontainer_op::insert, old_size, count - old_size);
+        }
+        else if (count < old_size)
+        {
+            emit(xcontainer_op::erase, count, old_size - count);
+        }
+    }
+
+    /**
+     * Replaces the content of the vector, emitting a single assign event.
+     */
+    template <class T, class A>
+    inline void xobservable_vector<T, A>::assign(container_type data)
+    {
+        m_data = std::move(data);
+        m_binding(assign_event());
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::assign_event() const noexcept -> event_type
+    {
+        return event_type{xcontainer_op::assign, 0u, m_data.size(), *this};
+    }
+
+    template <class T, class A>
+    inline void xobservable_vector<T, A>::emit(xcontainer_op op, size_type index, size_type count) const
+    {
+        m_binding(event_type{op, index, count, *this});
+    }
+
+    template <class T, class A>
+    inline auto xobservable_vector<T, A>::emit_insert(const_iterator pos, size_type old_size) -> const_iterator
+    {
+        size_type count = m_data.size() - old_size;
+        if (count != 0u)
+        {
+            emit(xcontainer_op::insert, static_cast<size_type>(pos - m_data.cbegin()), count);
+        }
+        return pos;
+    }
+
+    template <class T, class A>
+    inline bool operator==(const xobservable_vector<T, A>& lhs, const xobservable_vector<T, A>& rhs)
+    {
+        return lhs.value() == rhs.value();
+    }
+
+    template <class T, class A>
+    inline bool operator!=(const xobservable_vector<T, A>& lhs, const xobservable_vector<T, A>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    /**********************************
+     * xobservable_map implementation *
+     **********************************/
+
+    template <class K, class V, class C, class A>
+    inline xobservable_map<K, V, C, A>::xobservable_map(std::initializer_list<value_type> init)
+        : m_data(init)
+    {
+    }
+
+    template <class K, class V, class C, class A>
+    template <class It>
+    inline xobservable_map<K, V, C, A>::xobservable_map(It first, It last)
+        : m_data(first, last)
+    {
+    }
+
+    template <class K, class V, class C, class A>
+    inline xobservable_map<K, V, C, A>::xobservable_map(const container_type& data)
+        : m_data(data)
+    {
+    }
+
+    template <class K, class V, class C, class A>
+    inline xobservable_map<K, V, C, A>::xobservable_map(container_type&& data) noexcept
+        : m_data(std::move(data))
+    {
+    }
+
+    template <class K, class V, class C, class A>
+    inline auto xobservable_map<K, V, C, A>::value() const noexcept -> const container_type&
+    {
+        return m_data;
+    }
+
+    template <class K, class V, class C, class A>
+    inline xobservable_map<K, V, C, A>::operator const container_type&() const noexcept
+    {
+        return m_data;
+    }
+
+    template <class K, class V, class C, class A>
+    inline auto xobservable_map<K, V, C, A>::at(const key_type& key) const -> const mapped_type&
+    {
+        return m_data.at(key);
+    }
+
+    template <class K, class V, class C, class A>
+    inline auto xobservable_map<K, V, C, A>::find(const key_type& key) const -> const_iterator
+    {
+        return m_data.find(key);
+    }
+
+    template <class K, class V, class C, class A>
+    inline auto xobservable_map<K, V, C, A>::count(const key_type& key) const -> size_type
+    {
+        return m_data.count(key);
+    }
+
+    template <class K, class V, class C, class A>
+    inline auto xobservable_map<K, V, C, A>::begin() const noexcept -> const_iterator
+    {
+        return m_data.begin();
+    }
+
+    template <class K, class V, class C, class A>
+    inline auto xobservable_map<K, V, C, A>::end() const noexcept -> const_iterator
+    {
+        return m_data.end();
+    }
+
+    template <class K, class V, class C, class A>
+    inline auto xobservable_map<K, V, C, A>::cbegin() const noexcept -> const_iterator
+    {
+        return m_data.cbegin();
+    }
+
+    template <class K, class V, class C, class A>
+    inline auto xobservable_map<K, V, C, A>::cend() const noexcept -> const_iterator
+    {
+        return m_data.cend();
+    }
+
+    template <class K, class V, class C, class A>
+    inline auto xobservable_map<K, V, C, A>::rbegin() const noexcept -> const_reverse_iterator
+    {
+        return m_data.rbegin();
+    }
+
+    template <class K, class V, class C, class A>
+    inline auto xobservable_map<K, V, C, A>::rend() const noexcept -> const_reverse_iterator
+    {
+        return m_data.rend();
+    }
+
+    template <class K, class V, class C, class A>
+    inline bool xobservable_map<K, V, C, A>::empty() const noexcept
+    {
+        return m_data.empty();
+    }
+
+    template <class K, class V, class C, class A>
+    inline auto xobservable_map<K, V, C, A>::size() const noexcept -> size_type
+    {
+        return m_data.size();
+    }
+
+    template <class K, class V, class C, class A>
+    template <class M>
+    inline auto xobservable_map<K, V, C, A>::insert_or_assign(const key_type& key, M&& value) -> std::pair<const_iterator, bool>
+    {
+        auto res = m_data.insert_or_assign(key, std::forward<M>(value));
+        emit(res.second ? xcontainer_op::insert : xcontainer_op::replace, &(res.first->first));
+        return res;
+    }
+
+    template <class K, class V, class C, class A>
+    inline auto xobservable_map<K, V, C, A>::insert(const value_type& value) -> std::pair<const_iterator, bool>
+    {
+        return emit_insert(m_data.insert(value));
+    }
+
+    template <class K, class V, class C, class A>
+    inline auto xobservable_map<K, V, C, A>::insert(value_type&& value) -> std::pair<const_iterator, bool>
+    {
+        return emit_insert(m_data.insert(std::move(value)));
+    }
+
+    template <class K, class V, class C, class A>
+    template <class... Args>
+    inline auto xobservable_map<K, V, C, A>::emplace(Args&&... args) -> std::pair<const_iterator, bool>
+    {
+        return emit_insert(m_data.emplace(std::forward<Args>(args)...));
+    }
+
+    template <class K, class V, class C, class A>
+    inline auto xobservable_map<K, V, C, A>::erase(const_iterator pos) -> const_iterator
+    {
+        key_type key = pos->first;
+        auto it = m_data.erase(pos);
+        emit(xcontainer_op::erase, &key);
+        return it;
+    }
+
+    template <class K, class V, class C, class A>
+    inline auto xobservable_map<K, V, C, A>::erase(const key_type& key) -> size_type
+    {
+        // key may refer to the erased element, as in m.erase(m.begin()->first)
+        auto it = m_data.find(key);
+        if (it == m_data.end())
+        {
+            return 0u;
+        }
+        erase(const_iterator(it));
+        return 1u;
+    }
+
+    template <class K, class V, class C, class A>
+    inline void xobservable_map<K, V, C, A>::clear()
+    {
+        m_data.clear();
+        emit(xcontainer_op::clear, nullptr);
+    }
+
+    /**
+     * Replaces the content of the map, emitting a single assign event.
+     */
+    template <class K, class V, class C, class A>
+    inline void xobservable_map<K, V, C, A>::assign(container_type data)
+    {
+        m_data = std::move(data);
+        m_binding(assign_event());
+    }
+
+    template <class K, class V, class C, class A>
+    inline auto xobservable_map<K, V, C, A>::assign_event() const noexcept -> event_type
+    {
+        return event_type{xcontainer_op::assign, nullptr, *this};
+    }
+
+    template <class K, class V, class C, class A>
+    inline void xobservable_map<K, V, C, A>::emit(xcontainer_op op, const key_type* key) const
+    {
+        m_binding(event_type{op, key, *this});
+    }
+
+    template <class K, class V, class C, class A>
+    inline auto xobservable_map<K, V, C, A>::emit_insert(std::pair<typename container_type::iterator, bool> res)
+        -> std::pair<const_iterator, bool>
+    {
+        if (res.second)
+        {
+            emit(xcontainer_op::insert, &(res.first->first));
+        }
+        return res;
+    }
+
+    template <class K, class V, class C, class A>
+    inline bool operator==(const xobservable_map<K, V, C, A>& lhs, const xobservable_map<K, V, C, A>& rhs)
+    {
+        return lhs.value() == rhs.value();
+    }
+
+    template <class K, class V, class C, class A>
+    inline bool operator!=(const xobservable_map<K, V, C, A>& lhs, const xobservable_map<K, V, C, A>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+}
+
+#endif
@@ -9,10 +9,17 @@
 #ifndef XPROPERTY_JSON_HPP
 #define XPROPERTY_JSON_HPP
 
-#include "nlohmann/json.hpp" 
+#include <cstddef>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "nlohmann/json.hpp"
 
 #include "xproperty_config.hpp"
 #include "xproperty.hpp"
+#include "xcontainers.hpp"
 
 namespace xp
 {
@@ -26,6 +33,24 @@ namespace xp
     template <class T, class O>
     void from_json(const nlohmann::json&, xproperty<T, O>&);
 
+    template <class T, class A>
+    void to_json(nlohmann::json&, const xobservable_vector<T, A>&);
+
+    template <class T, class A>
+    void from_json(const nlohmann::json&, xobservable_vector<T, A>&);
+
+    template <class K, class V, class C, class A>
+    void to_json(nlohmann::json&, const xobservable_map<K, V, C, A>&);
+
+    template <class K, class V, class C, class A>
+    void from_json(const nlohmann::json&, xobservable_map<K, V, C, A>&);
+
+    template <class C>
+    void to_json(nlohmann::json&, const xvector_event<C>&);
+
+    template <class C>
+    void to_json(nlohmann::json&, const xmap_event<C>&);
+
     /****************************************
      * to_json and from_json implementation *
      ****************************************/
@@ -63,6 +88,144 @@ namespace xp
         using nlohmann::from_json;
         from_json(j, p());
     }
+
+    /**
+     * @brief JSON serialization of an xobservable_vector.
+     *
+     * @param j a JSON object
+     * @param c a const \ref xobservable_vector
+     */
+    template <class T, class A>
+    void to_json(nlohmann::json& j, const xobservable_vector<T, A>& c)
+    {
+        j = c.value();
+    }
+
+    /**
+     * @brief JSON deserialization of an xobservable_vector.
+     *
+     * The content of the vector is replaced with a single assign event.
+     *
+     * @param j a const JSON object
+     * @param c an \ref xobservable_vector
+     */
+    template <class T, class A>
+    void from_json(const nlohmann::json& j, xobservable_vector<T, A>& c)
+    {
+        c.assign(j.get<std::vector<T, A>>());
+    }
+
+    /**
+     * @brief JSON serialization of an xobservable_map.
+     *
+     * @param j a JSON object
+     * @param c a const \ref xobservable_map
+     */
+    template <class K, class V, class C, class A>
+    void to_json(nlohmann::json& j, const xobservable_map<K, V, C, A>& c)
+    {
+        j = c.value();
+    }
+
+    /**
+     * @brief JSON deserialization of an xobservable_map.
+     *
+     * The content of the map is replaced with a single assign event.
+     *
+     * @param j a const JSON object
+     * @param c an \ref xobservable_map
+     */
+    template <class K, class V, class C, class A>
+    void from_json(const nlohmann::json& j, xobservable_map<K, V, C, A>& c)
+    {
+        c.assign(j.get<std::map<K, V, C, A>>());
+    }
+
+    /**
+     * @brief JSON serialization of a change of an xobservable_vector.
+     *
+     * The change is serialized as an array of JSON Patch (RFC 6902)
+     * operations relative to the serialized vector.
+     *
+     * @param j a JSON object
+     * @param e a const \ref xvector_event
+     */
+    template <class C>
+    void to_json(nlohmann::json& j, const xvector_event<C>& e)
+    {
+        using pointer = nlohmann::json::json_pointer;
+        j = nlohmann::json::array();
+        switch (e.op)
+        {
+        case xcontainer_op::insert:
+        case xcontainer_op::replace:
+            for (std::size_t i = e.index; i < e.index + e.count; ++i)
+            {
+                j.push_back({
+                    {"op", e.op == xcontainer_op::insert ? "add" : "replace"},
+                    {"path", (pointer() / i).to_string()},
+                    {"value", e.container[i]}
+                });
+            }
+            break;
+        case xcontainer_op::erase:
+            for (std::size_t i = 0; i < e.count; ++i)
+            {
+                j.push_back({{"op", "remove"}, {"path", (pointer() / e.index).to_string()}});
+            }
+            break;
+        case xcontainer_op::clear:
+            j.push_back({{"op", "replace"}, {"path", ""}, {"value", nlohmann::json::array()}});
+            break;
+        case xcontainer_op::assign:
+            j.push_back({{"op", "replace"}, {"path", ""}, {"value", e.container}});
+            break;
+        }
+    }
+
+    /**
+     * @brief JSON serialization of a change of an xobservable_map.
+     *
+     * The change is serialized as an array of JSON Patch (RFC 6902)
+     * operations relative to the serialized map. Only maps with string
+     * keys are serialized as JSON objects, hence patches are restricted to
+     * them.
+     *
+     * @param j a JSON object
+     * @param e a const \ref xmap_event
+     */
+    template <class C>
+    void to_json(nlohmann::json& j, const xmap_event<C>& e)
+    {
+        static_assert(std::is_constructible<std::string, typename C::key_type>::value,
+                      "JSON patches require maps with string keys");
+        using pointer = nlohmann::json::json_pointer;
+        j = nlohmann::json::array();
+        if (e.op == xcontainer_op::clear)
+        {
+            j.push_back({{"op", "replace"}, {"path", ""}, {"value", nlohmann::json::object()}});
+            return;
+        }
+        if (e.op == xcontainer_op::assign)
+        {
+            j.push_back({{"op", "replace"}, {"path", ""}, {"value", e.container}});
+            return;
+        }
+
+        std::string path = (pointer() / std::string(*e.key)).to_string();
+        switch (e.op)
+        {
+        case xcontainer_op::insert:
+            j.push_back({{"op", "add"}, {"path", path}, {"value", e.container.at(*e.key)}});
+            break;
+        case xcontainer_op::replace:
+            j.push_back({{"op", "replace"}, {"path", path}, {"value", e.container.at(*e.key)}});
+            break;
+        default:
+            j.push_back({{"op", "remove"}, {"path", path}});
+            break;
+        }
+    }
 }
 
 #endif
@@ -0,0 +1,326 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XPROPERTY_LINK_HPP
+#define XPROPERTY_LINK_HPP
+
+#include <cstddef>
+
+#include "xvalidation.hpp"
+
+namespace xp
+{
+    class xlink_registry;
+
+    namespace detail
+    {
+        // A link propagates the value of an attribute of a source object to an
+        // attribute of a target object. It belongs to the outgoing list of the
+        // registry of its source and to the incoming list of the registry of
+        // its target. The reverse link of a bidirectional link is not
+        // propagated while the link is propagated, and vice versa. A link
+        // erased while its source propagates is only marked as erased, and
+        // deleted once the propagation is over. The propagate function returns
+        // the validation of the value by the target attribute.
+
+        struct xlink_node
+        {
+            using propagate_type = xvalidation (*)(void*, void*);
+
+            xlink_registry* p_source;
+            xlink_registry* p_target;
+            void* p_source_owner;
+            void* p_target_owner;
+            const char* m_source_name;
+            const char* m_target_name;
+            propagate_type m_propagate;
+            xlink_node* p_reverse;
+            bool m_busy;
+            bool m_erased;
+
+            xlink_node* p_prev_out;
+            xlink_node* p_next_out;
+            xlink_node* p_prev_in;
+            xlink_node* p_next_in;
+        };
+    }
+
+    /******************************
+     * xlink_registry declaration *
+     ******************************/
+
+    // Links of an xobserved object. Copying an object does not copy its links,
+    // and destroying or moving an object removes its links, so that no link
+    // refers to a destroyed object. Links can be removed by the observers
+    // invoked during a propagation, but the source object of the propagation
+    // must not be destroyed by them.
+
+    class xlink_registry
+    {
+    public:
+
+        using propagate_type = detail::xlink_node::propagate_type;
+
+        xlink_registry() = default;
+        ~xlink_registry();
+
+        xlink_registry(const xlink_registry&) noexcept;
+        xlink_registry& operator=(const xlink_registry&) noexcept;
+
+        xlink_registry(xlink_registry&&) noexcept;
+        xlink_registry& operator=(xlink_registry&&) noexcept;
+
+        detail::xlink_node* add(void* owner,
+                                const char* name,
+                                xlink_registry& target,
+                                void* target_owner,
+                                const char* target_name,
+                                propagate_type propagate);
+
+        xvalidation propagate(const char* name);
+
+        std::size_t remove(const char* name, const xlink_registry& target, const char* target_name) noexcept;
+        void clear() noexcept;
+
+        std::size_t size() const noexcept;
+
+    private:
+
+        void end_propagation() noexcept;
+        void sweep() noexcept;
+
+        static void erase(detail::xlink_node* node) noexcept;
+
+        detail::xlink_node* p_outgoing = nullptr;
+        detail::xlink_node* p_incoming = nullptr;
+        std::size_t m_depth = 0u;
+        bool m_has_erased = false;
+    };
+
+    /*********************************
+     * xlink_registry implementation *
+     *********************************/
+
+    inline xlink_registry::~xlink_registry()
+    {
+        clear();
+    }
+
+    inline xlink_registry::xlink_registry(const xlink_registry&) noexcept
+    {
+    }
+
+    inline xlink_registry& xlink_registry::operator=(const xlink_registry&) noexcept
+    {
+        return *this;
+    }
+
+    inline xlink_registry::xlink_registry(xlink_registry&& rhs) noexcept
+    {
+        rhs.clear();
+    }
+
+    inline xlink_registry& xlink_registry::operator=(xlink_registry&& rhs) noexcept
+    {
+        if (&rhs != this)
+        {
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    inline detail::xlink_node* xlink_registry::add(void* owner,
+                                                   const char* name,
+                                                   xlink_registry& target,
+                                                   void* target_owner,
+                                                   const char* target_name,
+                                                   propagate_type propagate)
+    {
+        auto* node = new detail::xlink_node{this, &target, owner, target_owner, name, target_name, propagate,
+                                            nullptr, false, false, nullptr, p_outgoing, nullptr, target.p_incoming};
+        if (p_outgoing != nullptr)
+        {
+            p_outgoing->p_prev_out = node;
+        }
+        p_outgoing = node;
+        if (target.p_incoming != nullptr)
+        {
+            target.p_incoming->p_prev_in = node;
+        }
+        target.p_incoming = node;
+        return node;
+    }
+
+    /**
+     * Propagates the attribute `name` through its outgoing links.
+     * @return the first rejection of the value by a target, if any.
+     */
+    inline xvalidation xlink_registry::propagate(const char* name)
+    {
+        // Nodes are not deleted while m_depth is not null, hence node and
+        // its successor remain valid whatever the propagation does.
+        ++m_depth;
+        xvalidation result = xvalidation::accept();
+        detail::xlink_node* node = p_outgoing;
+        while (node != nullptr)
+        {
+            bool reverse_busy = node->p_reverse != nullptr && node->p_reverse->m_busy;
+            if (!node->m_erased && node->m_source_name == name && !node->m_busy && !reverse_busy)
+            {
+                node->m_busy = true;
+                try
+                {
+                    xvalidation validation = node->m_propagate(node->p_source_owner, node->p_target_owner);
+                    if (!validation && result)
+                    {
+                        result = validation;
+                    }
+                }
+                catch (...)
+                {
+                    node->m_busy = false;
+                    end_propagation();
+                    throw;
+                }
+                node->m_busy = false;
+            }
+            node = node->p_next_out;
+        }
+        end_propagation();
+        return result;
+    }
+
+    /**
+     * Removes the links from the attribute `name` to the attribute
+     * `target_name` of the target.
+     * @return the number of removed links.
+     */
+    inline std::size_t xlink_registry::remove(const char* name, const xlink_registry& target, const char* target_name) noexcept
+    {
+        std::size_t count = 0u;
+        detail::xlink_node* node = p_outgoing;
+        while (node != nullptr)
+        {
+            detail::xlink_node* next = node->p_next_out;
+            if (!node->m_erased && node->p_target == &target && node->m_source_name == name && node->m_target_name == target_name)
+            {
+                erase(node);
+                ++count;
+            }
+            node = next;
+        }
+        return count;
+    }
+
+    inline void xlink_registry::clear() noexcept
+    {
+        detail::xlink_node* node = p_outgoing;
+        while (node != nullptr)
+        {
+            detail::xlink_node* next = node->p_next_out;
+            erase(node);
+            node = next;
+        }
+        while (p_incoming != nullptr)
+        {
+            erase(p_incoming);
+        }
+    }
+
+    /**
+     * Returns the number of links of which the object is the source or the target.
+     */
+    inline std::size_t xlink_registry::size() const noexcept
+    {
+        std::size_t count = 0u;
+        for (auto* node = p_outgoing; node != nullptr; node = node->p_next_out)
+        {
+            count += node->m_erased ? 0u : 1u;
+        }
+        for (auto* node = p_incoming; node != nullptr; node = node->p_next_in)
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    inline void xlink_registry::end_propagation() noexcept
+    {
+        if (--m_depth == 0u && m_has_erased)
+        {
+            sweep();
+        }
+    }
+
+    // Deletes the nodes erased during a propagation.
+    inline void xlink_registry::sweep() noexcept
+    {
+        m_has_erased = false;
+        detail::xlink_node* node = p_outgoing;
+        while (node != nullptr)
+        {
+            detail::xlink_node* next = node->p_next_out;
+            if (node->m_erased)
+            {
+                erase(node);
+            }
+            node = next;
+        }
+    }
+
+    // Removes the node from the incoming list of its target at once, and from
+    // the outgoing list of its source unless the source is propagating.
+    inline void xlink_registry::erase(detail::xlink_node* node) noexcept
+    {
+        if (!node->m_erased)
+        {
+            if (node->p_prev_in != nullptr)
+            {
+                node->p_prev_in->p_next_in = node->p_next_in;
+            }
+            else
+            {
+                node->p_target->p_incoming = node->p_next_in;
+            }
+            if (node->p_next_in != nullptr)
+            {
+                node->p_next_in->p_prev_in = node->p_prev_in;
+            }
+
+            if (node->p_reverse != nullptr)
+            {
+                node->p_reverse->p_reverse = nullptr;
+                node->p_reverse = nullptr;
+            }
+            node->m_erased = true;
+        }
+
+        xlink_registry* source = node->p_source;
+        if (source->m_depth != 0u)
+        {
+            source->m_has_erased = true;
+            return;
+        }
+
+        if (node->p_prev_out != nullptr)
+        {
+            node->p_prev_out->p_next_out = node->p_next_out;
+        }
+        else
+        {
+            source->p_outgoing = node->p_next_out;
+        }
+        if (node->p_next_out != nullptr)
+        {
+            node->p_next_out->p_prev_out = node->p_prev_out;
+        }
+        delete node;
+    }
+}
+
+#endif
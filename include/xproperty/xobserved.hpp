@@ -9,14 +9,19 @@
 #ifndef XOBSERVED_HPP
 #define XOBSERVED_HPP
 
-#include <any>
+#include <array>
 #include <cstddef>
 #include <functional>
 #include <type_traits>
-#include <map>
-#include <vector>
+#include <typeinfo>
+#include <utility>
 
+#include "xbuilder.hpp"
+#include "xchange_buffer.hpp"
+#include "xlink.hpp"
+#include "xobserved_core.hpp"
 #include "xproperty.hpp"
+#include "xsnapshot.hpp"
 
 namespace xp
 {
@@ -27,6 +32,13 @@ namespace xp
     #define XOBSERVE(O, A, C) \
     O.observe(O.derived_cast().A.name(), C);
 
+    // XOBSERVE_CHANGES(owner, Attribute, Callback)
+    // Register a callback reacting to element-level changes of the specified
+    // attribute of the owner, whose type must be an observable container.
+
+    #define XOBSERVE_CHANGES(O, A, C) \
+    O.observe_changes(O.derived_cast().A.name(), std::function<void(decltype(O)&, const typename decltype(O.A)::value_type::event_type&)>(C));
+
     // XUNOBSERVE(owner, Attribute)
     // Removes all callbacks reacting to changes of the specified attribute of the owner.
 
@@ -35,9 +47,11 @@ namespace xp
 
     // XVALIDATE(owner, Attribute, Validator)
     // Register a validator for proposed values of the specified attribute.
+    // The validator either returns void and throws to reject the proposal,
+    // or returns an xvalidation.
 
     #define XVALIDATE(O, A, C) \
-    O.validate(O.derived_cast().A.name(), std::function<void(decltype(O)&, typename decltype(O.A)::value_type&)>(C));
+    O.validate(O.derived_cast().A.name(), ::xp::detail::make_validator<decltype(O), typename decltype(O.A)::value_type>(C));
 
     // XUNVALIDATE(owner, Attribute)
     // Removes all validators for proposed values of the specified attribute.
@@ -45,20 +59,81 @@ namespace xp
     #define XUNVALIDATE(O, A) \
     O.unvalidate(O.derived_cast().A.name());
 
+    // XRECORD(owner, Attribute, Buffer)
+    // Record the changes of the specified attribute of the owner in an xchange_buffer.
+    // The address of the owner is the key of its records in the buffer, see XRECORD_KEY.
+
+    #define XRECORD(O, A, B) \
+    O.template record<typename decltype(O.A)::value_type>(O.derived_cast().A.name(), B, &O.derived_cast());
+
+    // XRECORD_KEY(owner, Attribute, Buffer, Key)
+    // Record the changes of the specified attribute of the owner in an xchange_buffer,
+    // with the specified key. Owners that are moved must use a key that does not depend
+    // on their address.
+
+    #define XRECORD_KEY(O, A, B, K) \
+    O.template record<typename decltype(O.A)::value_type>(O.derived_cast().A.name(), B, K);
+
+    // XUNRECORD(owner, Attribute)
+    // Stops recording the changes of the specified attribute of the owner.
+
+    #define XUNRECORD(O, A) \
+    O.unrecord(O.derived_cast().A.name());
+
     // XDLINK(Source, AttributeName, Target, AttributeName)
     // Link the value of an attribute of a source xobserved object with the value of a target object.
+    // The link is removed when either object is destroyed or moved.
+    //
+    // Links assign the target attribute with try_assign. When the target rejects a value, it keeps
+    // its own: assigning the source with try_assign reports the rejection, and assigning it with
+    // operator= throws an xvalidation_error once the source has its new value.
+
+    #define XLINK_PROPAGATE(S, SA, T, TA)                                                         \
+    [](void* xp_link_source_, void* xp_link_target_)                                              \
+    {                                                                                             \
+        using xp_link_source_type_ = typename std::decay_t<decltype(S)>::derived_type;            \
+        using xp_link_target_type_ = typename std::decay_t<decltype(T)>::derived_type;            \
+        return static_cast<xp_link_target_type_*>(xp_link_target_)->TA.try_assign(                \
+            static_cast<xp_link_source_type_*>(xp_link_source_)->SA()).validation();              \
+    }
 
-    #define XDLINK(S, SA, T, TA)                                                   \
-    T.TA = S.SA;                                                                   \
-    S.observe(S.derived_cast().SA.name(), [&S, &T](auto&) { T.TA = S.SA; });
+    #define XDLINK(S, SA, T, TA)                                                                  \
+    T.TA = S.SA();                                                                                \
+    S.link(S.derived_cast().SA.name(), T, T.derived_cast().TA.name(), XLINK_PROPAGATE(S, SA, T, TA));
 
     // XLINK(Source, AttributeName, Target, AttributeName)
     // Bidirectional link between attributes of two xobserved objects.
+    // The link is removed when either object is destroyed or moved.
+    //
+    // The reverse link is not propagated while the link is propagated. When a validator of the
+    // target coerces the value, the coerced value is assigned back to the source once, so that
+    // both attributes keep the same value. This requires values comparable with operator==.
+
+    #define XLINK_RECONCILE(S, SA, T, TA)                                                         \
+    [](void* xp_link_source_, void* xp_link_target_)                                              \
+    {                                                                                             \
+        using xp_link_source_type_ = typename std::decay_t<decltype(S)>::derived_type;            \
+        using xp_link_target_type_ = typename std::decay_t<decltype(T)>::derived_type;            \
+        auto& xp_source_ = static_cast<xp_link_source_type_*>(xp_link_source_)->SA;               \
+        auto& xp_target_ = static_cast<xp_link_target_type_*>(xp_link_target_)->TA;               \
+        ::xp::xvalidation xp_validation_ = xp_target_.try_assign(xp_source_()).validation();      \
+        if (xp_validation_)                                                                       \
+        {                                                                                         \
+            xp_validation_ = ::xp::detail::reconcile_link(xp_source_, xp_target_);                \
+        }                                                                                         \
+        return xp_validation_;                                                                    \
+    }
+
+    #define XLINK(S, SA, T, TA)                                                                   \
+    T.TA = S.SA();                                                                                \
+    S.link(S.derived_cast().SA.name(), T, T.derived_cast().TA.name(),                             \
+           XLINK_RECONCILE(S, SA, T, TA), XLINK_RECONCILE(T, TA, S, SA));
 
-    #define XLINK(S, SA, T, TA)                                                    \
-    T.TA = S.SA;                                                                   \
-    S.observe(S.derived_cast().SA.name(), [&S, &T](const auto&) { T.TA = S.SA; }); \
-    T.observe(T.derived_cast().TA.name(), [&S, &T](const auto&) { S.SA = T.TA; });
+    // XUNLINK(Source, AttributeName, Target, AttributeName)
+    // Removes the links between attributes of two xobserved objects, in both directions.
+
+    #define XUNLINK(S, SA, T, TA)                                                                 \
+    S.unlink(S.derived_cast().SA.name(), T, T.derived_cast().TA.name());
 
     /*************************
      * xobserved declaration *
@@ -76,13 +151,41 @@ namespace xp
 
         void observe(const char*, std::function<void(derived_type&)>);
 
+        template <class E>
+        void observe_changes(const char*, std::function<void(derived_type&, const E&)>);
+
         void unobserve(const char*);
 
         template <class V>
         void validate(const char*, std::function<void(derived_type&, V&)>);
 
+        template <class V>
+        void validate(const char*, std::function<xvalidation(derived_type&, V&)>);
+
         void unvalidate(const char*);
 
+        template <class T, class V>
+        void record(const char*, xchange_buffer<V>&, const void* key);
+
+        void unrecord(const char*);
+
+        template <class E>
+        void link(const char*, xobserved<E>&, const char*, xlink_registry::propagate_type);
+
+        template <class E>
+        void link(const char*, xobserved<E>&, const char*, xlink_registry::propagate_type, xlink_registry::propagate_type);
+
+        template <class E>
+        void unlink(const char*, xobserved<E>&, const char*);
+
+        std::size_t link_count() const noexcept;
+
+        template <class... M>
+        xsnapshot<derived_type, M...> snapshot(M... properties) const;
+
+        template <class... M>
+        void restore(const xsnapshot<derived_type, M...>&);
+
     protected:
 
         xobserved() = default;
@@ -96,23 +199,68 @@ namespace xp
 
     private:
 
-        std::map<const char*, std::tuple<std::vector<std::any>, std::vector<std::function<void(derived_type&)>>>> m_accesses;
+        detail::xobserved_core m_core;
 
         template <class X, class Y>
         friend class xproperty;
 
-        template <class T>
-        void notify(const char*, const T&);
+        template <class E>
+        friend class xobserved;
 
-        void invoke_observers(const char*);
+        detail::xassign_outcome assign_value(const char*, const std::type_info& type, void* value, void* proposal,
+                                             detail::move_assign_type, detail::emit_assign_type);
+        xvalidation initialize_value(const char*, const std::type_info& type, void* value, void* proposal, detail::move_assign_type);
 
-        template <class T, class V>
-        auto invoke_validators(const char*, V&& r);
+        void notify(const char*, const std::type_info& type, const void* old_value, const void* new_value);
+
+        xvalidation invoke_observers(const char*);
+
+        void invoke_change_observers(const char*, const std::type_info& type, const void* event);
+
+        template <class M, class T>
+        bool restore_value(M property, const T& value);
+
+        template <class S, std::size_t... I>
+        void restore_impl(const S& snapshot, std::index_sequence<I...>);
     };
 
     template <class E>
     using is_xobserved = std::is_base_of<xobserved<E>, E>;
 
+    namespace detail
+    {
+        template <class D, class V, class F>
+        inline auto make_validator(F&& f)
+        {
+            using owner_type = std::decay_t<D>;
+            if constexpr (is_status_validator<F, owner_type, V>::value)
+            {
+                return std::function<xvalidation(owner_type&, V&)>(std::forward<F>(f));
+            }
+            else
+            {
+                return std::function<void(owner_type&, V&)>(std::forward<F>(f));
+            }
+        }
+
+        // Assigns the value of the target of a bidirectional link back to the
+        // source if the target coerced it, see XLINK.
+        template <class S, class T>
+        inline xvalidation reconcile_link(S& source, const T& target)
+        {
+            using source_value_type = typename S::value_type;
+            using target_value_type = typename T::value_type;
+            if constexpr (is_equality_comparable<source_value_type, target_value_type>::value)
+            {
+                if (!(source() == target()))
+                {
+                    return source.try_assign(target()).validation();
+                }
+            }
+            return xvalidation::accept();
+        }
+    }
+
     /****************************
      * xobserved implementation *
      ****************************/
@@ -132,56 +280,262 @@ namespace xp
     template <class D>
     inline void xobserved<D>::observe(const char* name, std::function<void(derived_type&)> cb)
     {
-        std::get<1>(m_accesses[name]).emplace_back(std::move(cb));
+        m_core[name].m_observers.emplace_back([cb = std::move(cb)](void* owner)
+        {
+            cb(*static_cast<derived_type*>(owner));
+        });
+    }
+
+    template <class D>
+    template <class E>
+    inline void xobserved<D>::observe_changes(const char* name, std::function<void(derived_type&, const E&)> cb)
+    {
+        auto& observers = m_core.at(name, typeid(typename E::container_type)).m_change_observers;
+        observers.emplace_back([cb = std::move(cb)](void* owner, const void* event)
+        {
+            cb(*static_cast<derived_type*>(owner), *static_cast<const E*>(event));
+        });
     }
 
     template <class D>
     inline void xobserved<D>::unobserve(const char* name)
     {
-        std::get<1>(m_accesses[name]).clear();
+        auto& access = m_core[name];
+        access.m_observers.clear();
+        access.m_change_observers.clear();
     }
 
+    /**
+     * Registers a validator for the specified property. V must be the value
+     * type of the property.
+     * @throw std::invalid_argument if callbacks of the property were registered
+     * with another value type. Assigning the property throws the same exception
+     * if V is not its value type.
+     */
     template <class D>
     template <class V>
     inline void xobserved<D>::validate(const char* name, std::function<void(derived_type&, V&)> cb)
     {
-        std::get<0>(m_accesses[name]).emplace_back(std::move(cb));
+        m_core.at(name, typeid(V)).m_validators.emplace_back([cb = std::move(cb)](void* owner, void* proposal)
+        {
+            cb(*static_cast<derived_type*>(owner), *static_cast<V*>(proposal));
+            return xvalidation::accept();
+        });
+    }
+
+    /**
+     * Registers a validator for the specified property. V must be the value
+     * type of the property.
+     * @throw std::invalid_argument if callbacks of the property were registered
+     * with another value type. Assigning the property throws the same exception
+     * if V is not its value type.
+     */
+    template <class D>
+    template <class V>
+    inline void xobserved<D>::validate(const char* name, std::function<xvalidation(derived_type&, V&)> cb)
+    {
+        m_core.at(name, typeid(V)).m_validators.emplace_back([cb = std::move(cb)](void* owner, void* proposal)
+        {
+            return cb(*static_cast<derived_type*>(owner), *static_cast<V*>(proposal));
+        });
     }
 
     template <class D>
     inline void xobserved<D>::unvalidate(const char* name)
     {
-        std::get<0>(m_accesses[name]).clear();
+        m_core[name].m_validators.clear();
+    }
+
+    /**
+     * Records the changes of the specified property in the buffer. Only the
+     * indices of the changed properties are recorded if the value type of the
+     * buffer is void; otherwise the value type of the property must be
+     * assignable to it. key identifies the owner in the buffer, see
+     * xchange_buffer::key. The buffer must outlive the recording, which
+     * is not copied with the owner.
+     */
+    template <class D>
+    template <class T, class V>
+    inline void xobserved<D>::record(const char* name, xchange_buffer<V>& buffer, const void* key)
+    {
+        auto& recorder = m_core.at(name, typeid(T)).m_recorder;
+        recorder.p_buffer = &buffer;
+        recorder.m_index = buffer.register_property(name, key);
+        recorder.m_write = [](void* b, std::size_t index, const void* old_value, const void* new_value)
+        {
+            auto& buf = *static_cast<xchange_buffer<V>*>(b);
+            if constexpr (std::is_void<V>::value)
+            {
+                buf.push(index);
+            }
+            else if (old_value != nullptr)
+            {
+                buf.push(index, *static_cast<const T*>(old_value), *static_cast<const T*>(new_value));
+            }
+            else
+            {
+                buf.push(index, V(), *static_cast<const T*>(new_value));
+            }
+        };
+    }
+
+    template <class D>
+    inline void xobserved<D>::unrecord(const char* name)
+    {
+        m_core[name].m_recorder = detail::xchange_recorder();
+    }
+
+    /**
+     * Links the attribute `name` to the attribute `target_name` of the target:
+     * propagate is called with the derived objects when the attribute changes.
+     */
+    template <class D>
+    template <class E>
+    inline void xobserved<D>::link(const char* name,
+                                   xobserved<E>& target,
+                                   const char* target_name,
+                                   xlink_registry::propagate_type propagate)
+    {
+        m_core.links().add(&derived_cast(), name, target.m_core.links(), &target.derived_cast(), target_name, propagate);
+    }
+
+    /**
+     * Links the attribute `name` and the attribute `target_name` of the
+     * target in both directions.
+     */
+    template <class D>
+    template <class E>
+    inline void xobserved<D>::link(const char* name,
+                                   xobserved<E>& target,
+                                   const char* target_name,
+                                   xlink_registry::propagate_type forward,
+                                   xlink_registry::propagate_type backward)
+    {
+        xlink_registry& links = m_core.links();
+        xlink_registry& target_links = target.m_core.links();
+        auto* forward_link = links.add(&derived_cast(), name, target_links, &target.derived_cast(), target_name, forward);
+        auto* backward_link = target_links.add(&target.derived_cast(), target_name, links, &derived_cast(), name, backward);
+        forward_link->p_reverse = backward_link;
+        backward_link->p_reverse = forward_link;
+    }
+
+    template <class D>
+    template <class E>
+    inline void xobserved<D>::unlink(const char* name, xobserved<E>& target, const char* target_name)
+    {
+        m_core.links().remove(name, target.m_core.links(), target_name);
+        target.m_core.links().remove(target_name, m_core.links(), name);
+    }
+
+    /**
+     * Returns the number of links of which the object is the source or the target.
+     */
+    template <class D>
+    inline std::size_t xobserved<D>::link_count() const noexcept
+    {
+        return m_core.links().size();
+    }
+
+    /**
+     * Returns the values of the specified properties, given as pointers to
+     * members of the derived class. At least one property must be specified.
+     */
+    template <class D>
+    template <class... M>
+    inline auto xobserved<D>::snapshot(M... properties) const -> xsnapshot<derived_type, M...>
+    {
+        return xsnapshot<derived_type, M...>(derived_cast(), properties...);
     }
 
+    /**
+     * Restores the values of a snapshot. Validators are not invoked. Once all
+     * the values are restored, the observers of the properties whose value
+     * differed from the snapshot are invoked. Restored container properties
+     * emit an assign change event.
+     * @throw xvalidation_error if a linked property rejects a restored value,
+     * once all the observers are invoked.
+     */
     template <class D>
-    template <class T>
-    inline void xobserved<D>::notify(const char*, const T&)
+    template <class... M>
+    inline void xobserved<D>::restore(const xsnapshot<derived_type, M...>& snapshot)
     {
+        restore_impl(snapshot, std::index_sequence_for<M...>());
     }
 
     template <class D>
-    inline void xobserved<D>::invoke_observers(const char* name)
+    template <class M, class T>
+    inline bool xobserved<D>::restore_value(M property, const T& value)
     {
-        for(auto& observer : std::get<1>(m_accesses[name]))
+        auto& p = derived_cast().*property;
+        if constexpr (detail::is_equality_comparable<T>::value)
         {
-            observer(derived_cast());
+            if (p() == value)
+            {
+                return false;
+            }
         }
+        notify(p.name(), typeid(T), &p(), &value);
+        p() = value;
+        if constexpr (is_xobservable_container<T>::value)
+        {
+            std::decay_t<decltype(p)>::emit_assign(&derived_cast(), p.name(), &p());
+        }
+        return true;
     }
 
     template <class D>
-    template <class T, class V>
-    inline auto xobserved<D>::invoke_validators(const char* name, V&& v)
+    template <class S, std::size_t... I>
+    inline void xobserved<D>::restore_impl(const S& snapshot, std::index_sequence<I...>)
     {
-        using value_type = T;
-        value_type value(std::forward<V>(v));
-
-        for(auto& validator : std::get<0>(m_accesses[name]))
+        std::array<bool, sizeof...(I)> changed = {
+            { restore_value(std::get<I>(snapshot.m_members), std::get<I>(snapshot.m_values))... }
+        };
+        xvalidation result = xvalidation::accept();
+        auto invoke = [this, &result](const char* name)
         {
-            std::any_cast<std::function<void(derived_type&, value_type&)>>(validator)(derived_cast(), value);
+            xvalidation validation = invoke_observers(name);
+            if (!validation && result)
+            {
+                result = validation;
+            }
+        };
+        ((changed[I] ? invoke((derived_cast().*std::get<I>(snapshot.m_members)).name()) : void()), ...);
+        if (!result)
+        {
+            throw xvalidation_error(result.reason());
         }
+    }
 
-        return value;
+    template <class D>
+    inline detail::xassign_outcome xobserved<D>::assign_value(const char* name, const std::type_info& type, void* value, void* proposal,
+                                                              detail::move_assign_type move, detail::emit_assign_type emit)
+    {
+        return m_core.assign(&derived_cast(), name, type, value, proposal, move, emit);
+    }
+
+    template <class D>
+    inline xvalidation xobserved<D>::initialize_value(const char* name, const std::type_info& type, void* value, void* proposal,
+                                                      detail::move_assign_type move)
+    {
+        return m_core.initialize(&derived_cast(), name, type, value, proposal, move);
+    }
+
+    template <class D>
+    inline void xobserved<D>::notify(const char* name, const std::type_info& type, const void* old_value, const void* new_value)
+    {
+        m_core.notify(name, type, old_value, new_value);
+    }
+
+    template <class D>
+    inline xvalidation xobserved<D>::invoke_observers(const char* name)
+    {
+        return m_core.invoke_observers(&derived_cast(), name);
+    }
+
+    template <class D>
+    inline void xobserved<D>::invoke_change_observers(const char* name, const std::type_info& type, const void* event)
+    {
+        m_core.invoke_change_observers(&derived_cast(), name, type, event);
     }
 }
 
@@ -0,0 +1,302 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XPROPERTY_OBSERVED_CORE_HPP
+#define XPROPERTY_OBSERVED_CORE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "xlink.hpp"
+#include "xproperty.hpp"
+#include "xvalidation.hpp"
+
+namespace xp
+{
+    namespace detail
+    {
+        // Writes the changes of a property in an xchange_buffer whose type
+        // is erased, without the overhead of std::function. Copies do not
+        // record: the index of the property in the buffer identifies the
+        // original owner. Moves keep recording.
+        struct xchange_recorder
+        {
+            using write_type = void (*)(void*, std::size_t, const void*, const void*);
+
+            xchange_recorder() = default;
+            ~xchange_recorder() = default;
+
+            xchange_recorder(const xchange_recorder&) noexcept;
+            xchange_recorder& operator=(const xchange_recorder&) noexcept;
+
+            xchange_recorder(xchange_recorder&&) noexcept = default;
+            xchange_recorder& operator=(xchange_recorder&&) noexcept = default;
+
+            void* p_buffer = nullptr;
+            std::size_t m_index = 0u;
+            write_type m_write = nullptr;
+        };
+
+        // Callbacks registered for a property. The owner and the values are
+        // passed as untyped pointers, so that the code invoking the callbacks
+        // is shared by all the properties of all the owner types. m_type
+        // identifies the value type the typed callbacks were registered with,
+        // it is checked against the type of the property upon each change.
+        // type_info objects are compared by value rather than by address,
+        // since a type may have a distinct one in each shared library.
+        struct xaccess
+        {
+            using validator_type = std::function<xvalidation(void*, void*)>;
+            using observer_type = std::function<void(void*)>;
+            using change_observer_type = std::function<void(void*, const void*)>;
+
+            std::vector<validator_type> m_validators;
+            std::vector<observer_type> m_observers;
+            std::vector<change_observer_type> m_change_observers;
+            xchange_recorder m_recorder;
+            const std::type_info* m_type = nullptr;
+        };
+
+        /******************************
+         * xobserved_core declaration *
+         ******************************/
+
+        // Non-template part of xobserved: callbacks and links of an object
+        // and the assignment of its properties.
+
+        class xobserved_core
+        {
+        public:
+
+            xaccess& operator[](const char* name);
+            xaccess& at(const char* name, const std::type_info& type);
+
+            xassign_outcome assign(void* owner, const char* name, const std::type_info& type, void* value, void* proposal,
+                                   move_assign_type move, emit_assign_type emit);
+            xvalidation initialize(void* owner, const char* name, const std::type_info& type, void* value, void* proposal,
+                                   move_assign_type move);
+
+            void notify(const char* name, const std::type_info& type, const void* old_value, const void* new_value);
+            xvalidation invoke_observers(void* owner, const char* name);
+            void invoke_change_observers(void* owner, const char* name, const std::type_info& type, const void* event);
+
+            xlink_registry& links() noexcept;
+            const xlink_registry& links() const noexcept;
+
+        private:
+
+            xaccess* find(const char* name);
+            xaccess* find(const char* name, const std::type_info& type);
+
+            [[noreturn]] static void throw_type_mismatch(const char* name);
+
+            static xvalidation invoke_validators(xaccess& access, void* owner, void* proposal);
+            static void notify(const xaccess& access, const void* old_value, const void* new_value);
+
+            std::map<const char*, xaccess> m_accesses;
+            xlink_registry m_links;
+        };
+
+        /***********************************
+         * xchange_recorder implementation *
+         ***********************************/
+
+        inline xchange_recorder::xchange_recorder(const xchange_recorder&) noexcept
+        {
+        }
+
+        inline xchange_recorder& xchange_recorder::operator=(const xchange_recorder&) noexcept
+        {
+            *this = xchange_recorder();
+            return *this;
+        }
+
+        /*********************************
+         * xobserved_core implementation *
+         *********************************/
+
+        inline xaccess& xobserved_core::operator[](const char* name)
+        {
+            return m_accesses[name];
+        }
+
+        /**
+         * Returns the callbacks of a property, for the registration of
+         * callbacks typed with the value type identified by type.
+         * @throw std::invalid_argument if callbacks were registered with another type.
+         */
+        inline xaccess& xobserved_core::at(const char* name, const std::type_info& type)
+        {
+            xaccess& access = m_accesses[name];
+            if (access.m_type == nullptr)
+            {
+                access.m_type = &type;
+            }
+            else if (*access.m_type != type)
+            {
+                throw_type_mismatch(name);
+            }
+            return access;
+        }
+
+        /**
+         * Validates the proposal and moves it into the value of the property
+         * unless it is rejected, then emits the change event of the whole
+         * value if emit is not null, and invokes the observers and the links.
+         */
+        inline xassign_outcome xobserved_core::assign(void* owner, const char* name, const std::type_info& type, void* value, void* proposal,
+                                                      move_assign_type move, emit_assign_type emit)
+        {
+            xaccess* access = find(name, type);
+            if (access != nullptr)
+            {
+                xvalidation validation = invoke_validators(*access, owner, proposal);
+                if (!validation)
+                {
+                    return {validation, xvalidation::accept()};
+                }
+                notify(*access, value, proposal);
+                move(value, proposal);
+                if (emit != nullptr)
+                {
+                    emit(owner, name, value);
+                }
+                for (auto& observer : access->m_observers)
+                {
+                    observer(owner);
+                }
+                return {validation, m_links.propagate(name)};
+            }
+            move(value, proposal);
+            return {xvalidation::accept(), m_links.propagate(name)};
+        }
+
+        /**
+         * Validates the proposal and moves it into the value of the property
+         * unless it is rejected. Changes are neither recorded nor observed,
+         * nor propagated through links: the owner is under construction.
+         */
+        inline xvalidation xobserved_core::initialize(void* owner, const char* name, const std::type_info& type, void* value, void* proposal,
+                                                      move_assign_type move)
+        {
+            xaccess* access = find(name, type);
+            xvalidation validation = access != nullptr ? invoke_validators(*access, owner, proposal) : xvalidation::accept();
+            if (validation)
+            {
+                move(value, proposal);
+            }
+            return validation;
+        }
+
+        // Called upon each change of a property, prior to the invocation of its
+        // observers. old_value is null for element-level changes of containers.
+        inline void xobserved_core::notify(const char* name, const std::type_info& type, const void* old_value, const void* new_value)
+        {
+            xaccess* access = find(name, type);
+            if (access != nullptr)
+            {
+                notify(*access, old_value, new_value);
+            }
+        }
+
+        /**
+         * Invokes the observers and the links of a property.
+         * @return the first rejection of the value by a linked property, if any.
+         */
+        inline xvalidation xobserved_core::invoke_observers(void* owner, const char* name)
+        {
+            xaccess* access = find(name);
+            if (access != nullptr)
+            {
+                for (auto& observer : access->m_observers)
+                {
+                    observer(owner);
+                }
+            }
+            return m_links.propagate(name);
+        }
+
+        inline void xobserved_core::invoke_change_observers(void* owner, const char* name, const std::type_info& type, const void* event)
+        {
+            xaccess* access = find(name, type);
+            if (access != nullptr)
+            {
+                for (auto& observer : access->m_change_observers)
+                {
+                    observer(owner, event);
+                }
+            }
+        }
+
+        inline xlink_registry& xobserved_core::links() noexcept
+        {
+            return m_links;
+        }
+
+        inline const xlink_registry& xobserved_core::links() const noexcept
+        {
+            return m_links;
+        }
+
+        inline xaccess* xobserved_core::find(const char* name)
+        {
+            auto it = m_accesses.find(name);
+            return it != m_accesses.end() ? &(it->second) : nullptr;
+        }
+
+        inline xaccess* xobserved_core::find(const char* name, const std::type_info& type)
+        {
+            xaccess* access = find(name);
+            if (access != nullptr && access->m_type != nullptr && *access->m_type != type)
+            {
+                throw_type_mismatch(name);
+            }
+            return access;
+        }
+
+        inline void xobserved_core::throw_type_mismatch(const char* name)
+        {
+            throw std::invalid_argument(std::string("callbacks of property ") + name +
+                                        " registered with another value type");
+        }
+
+        inline xvalidation xobserved_core::invoke_validators(xaccess& access, void* owner, void* proposal)
+        {
+            xvalidation result = xvalidation::accept();
+            for (auto& validator : access.m_validators)
+            {
+                xvalidation validation = validator(owner, proposal);
+                if (!validation)
+                {
+                    return validation;
+                }
+                if (validation.status() == xvalidation_status::coerce)
+                {
+                    result = validation;
+                }
+            }
+            return result;
+        }
+
+        inline void xobserved_core::notify(const xaccess& access, const void* old_value, const void* new_value)
+        {
+            const xchange_recorder& recorder = access.m_recorder;
+            if (recorder.m_write != nullptr)
+            {
+                recorder.m_write(recorder.p_buffer, recorder.m_index, old_value, new_value);
+            }
+        }
+    }
+}
+
+#endif
@@ -10,14 +10,55 @@
 #define XPROPERTY_HPP
 
 #include <cstddef>
+#include <functional>
 #include <type_traits>
+#include <typeinfo>
 #include <utility>
 
+#include "xvalidation.hpp"
+
 namespace xp
 {
 
     #define XP_NOEXCEPT(V) noexcept(noexcept((std::is_nothrow_constructible<V>::value)))
 
+    // Specialized for the value types emitting element-level change events,
+    // see xcontainers.hpp.
+
+    template <class T>
+    struct is_xobservable_container : std::false_type
+    {
+    };
+
+    template <class D>
+    class xbuilder;
+
+    namespace detail
+    {
+        // Moves the value pointed to by the second argument into the value
+        // pointed to by the first argument.
+        using move_assign_type = void (*)(void*, void*);
+
+        template <class T>
+        inline void move_assign(void* value, void* proposal)
+        {
+            *static_cast<T*>(value) = std::move(*static_cast<T*>(proposal));
+        }
+
+        // Outcome of the assignment of a property: the validation of the
+        // proposal, and the first rejection of the new value by a linked
+        // property, if any.
+        struct xassign_outcome
+        {
+            xvalidation m_validation;
+            xvalidation m_link_validation;
+        };
+
+        // Emits the change event of the assignment of the whole value pointed
+        // to by the third argument, for observable containers.
+        using emit_assign_type = void (*)(void*, const char*, const void*);
+    }
+
     /*************************
      * xproperty declaration *
      *************************/
@@ -43,41 +84,66 @@ namespace xp
         template <class V, class LV>
         xproperty(owner_type* owner, const char* name, V&& value, LV&& lambda_validator) XP_NOEXCEPT(value_type);
 
+        ~xproperty() = default;
+
+        xproperty(const xproperty&);
+        xproperty& operator=(const xproperty&) = default;
+
+        xproperty(xproperty&&) noexcept(std::is_nothrow_move_constructible<value_type>::value);
+        xproperty& operator=(xproperty&&) = default;
+
         operator reference() noexcept;
         operator const_reference() const noexcept;
 
         reference operator()() noexcept;
         const_reference operator()() const noexcept;
 
-        owner_type operator()(const value_type& arg) && noexcept;
-        owner_type operator()(value_type&& arg) && noexcept;
+        // Chained setters of temporary owners. Each call returns the owner by
+        // value, hence moves it: use xbuilder to initialize several properties
+        // in place.
+        owner_type operator()(const value_type& arg) &&;
+        owner_type operator()(value_type&& arg) &&;
 
         template <class Arg, class... Args>
-        owner_type operator()(Arg&& arg, Args&&... args) && noexcept;
+        owner_type operator()(Arg&& arg, Args&&... args) &&;
 
 // Workaround for MSVC: MSVC calls operator() const & overload instead
 // of operator() && overloads of temporaries in method chaining. Not
 // defining operator() const & overload results in a failing build
 // with error C3849.
 #ifdef _MSC_VER
-        owner_type operator()(const value_type& arg) const & noexcept;
-        owner_type operator()(value_type&& arg) const & noexcept;
+        owner_type operator()(const value_type& arg) const &;
+        owner_type operator()(value_type&& arg) const &;
 
         template <class Arg, class... Args>
-        owner_type operator()(Arg&& arg, Args&&... args) const & noexcept;
+        owner_type operator()(Arg&& arg, Args&&... args) const &;
 #endif
         const char* name() const noexcept;
 
         template <class V>
         reference operator=(V&&);
 
+        template <class V>
+        xassign_result<value_type> try_assign(V&&);
+
     private:
 
         owner_type* owner() noexcept;
+        detail::xassign_outcome assign(value_type& proposal);
+        void initialize(value_type& proposal);
+        void bind_value() noexcept;
+
+        static void emit_assign(void* owner, const char* name, const void* value);
 
         std::ptrdiff_t m_offset;
         const char* m_name;
         value_type m_value;
+
+        template <class D>
+        friend class xbuilder;
+
+        template <class D>
+        friend class xobserved;
     };
 
     /********************************************************
@@ -90,14 +156,24 @@ namespace xp
     //
     // Defines a property of the specified type and name, for the specified owner type.
     //
-    // The owner type must have two methods
+    // The owner type must have the methods
+    //
+    //  - detail::xassign_outcome assign_value(const char* name, const std::type_info& type, void* value, void* proposal,
+    //                                         detail::move_assign_type move, detail::emit_assign_type emit);
+    //  - xvalidation initialize_value(const char* name, const std::type_info& type, void* value, void* proposal,
+    //                                 detail::move_assign_type move);
+    //  - void notify(const char* name, const std::type_info& type, const void* old_value, const void* new_value);
+    //  - xvalidation invoke_observers(const char* name);
+    //  - void invoke_change_observers(const char* name, const std::type_info& type, const void* event);
     //
-    //  - template <class P, class V>
-    //    auto invoke_validators(const std::string& name, V&& proposal) const;
-    //  - void invoke_observers(const std::string& name) const;
+    // `assign_value` validates the proposal and moves it into the value with `move`
+    // unless it is rejected. `initialize_value` does the same for an owner under
+    // construction, without notifying the change. The values are type-erased, so
+    // that the code of the owner does not depend on the type of the property, and
+    // `type` is the typeid of the value type, checked against the type
+    // the callbacks of the property were registered with.
     //
-    // The `T` typename is a universal reference on the proposed value.
-    // The return type of `invoke_validator` must be convertible to the value_type of the property.
+    // The validator may return an xvalidation to reject the proposal without throwing.
 
     #define XPROPERTY_GENERAL(T, O, D, DEFAULT_VALUE, lambda_validator)                                  \
     ::xp::xproperty<T, O> D = (::xp::xproperty<T, O>(static_cast<O*>(this), #D, T(DEFAULT_VALUE), lambda_validator));
@@ -138,6 +214,7 @@ namespace xp
         , m_name(name)
         , m_value(std::forward<V>(value))
     {
+        bind_value();
     }
 
     template <class T, class O>
@@ -148,10 +225,38 @@ namespace xp
                                       LV&& lambda_validator) XP_NOEXCEPT(value_type)
         : xproperty(owner, name, std::forward<V>(value))
     {
-        owner->validate(m_name, std::function<void(owner_type&, value_type&)>(
-            [lambda_validator](owner_type&, value_type& v)
-            { lambda_validator(v); }
-            ));
+        if constexpr (std::is_same<std::invoke_result_t<LV, value_type&>, xvalidation>::value)
+        {
+            owner->validate(m_name, std::function<xvalidation(owner_type&, value_type&)>(
+                [lambda_validator](owner_type&, value_type& v)
+                { return lambda_validator(v); }
+                ));
+        }
+        else
+        {
+            owner->validate(m_name, std::function<void(owner_type&, value_type&)>(
+                [lambda_validator](owner_type&, value_type& v)
+                { lambda_validator(v); }
+                ));
+        }
+    }
+
+    template <class T, class O>
+    inline xproperty<T, O>::xproperty(const xproperty& rhs)
+        : m_offset(rhs.m_offset)
+        , m_name(rhs.m_name)
+        , m_value(rhs.m_value)
+    {
+        bind_value();
+    }
+
+    template <class T, class O>
+    inline xproperty<T, O>::xproperty(xproperty&& rhs) noexcept(std::is_nothrow_move_constructible<value_type>::value)
+        : m_offset(rhs.m_offset)
+        , m_name(rhs.m_name)
+        , m_value(std::move(rhs.m_value))
+    {
+        bind_value();
     }
 
     template <class T, class O>
@@ -179,50 +284,54 @@ namespace xp
     }
 
     template <class T, class O>
-    inline auto xproperty<T, O>::operator()(const value_type& arg) && noexcept -> owner_type
+    inline auto xproperty<T, O>::operator()(const value_type& arg) && -> owner_type
     {
-        m_value = arg;
+        value_type proposal(arg);
+        initialize(proposal);
         return std::move(*owner());
     }
 
     template <class T, class O>
-    inline auto xproperty<T, O>::operator()(value_type&& arg) && noexcept -> owner_type
+    inline auto xproperty<T, O>::operator()(value_type&& arg) && -> owner_type
     {
-        m_value = std::move(arg);
+        initialize(arg);
         return std::move(*owner());
     }
 
     template <class T, class O>
     template <class Arg, class... Args>
-    inline auto xproperty<T, O>::operator()(Arg&& arg, Args&&... args) && noexcept -> owner_type
+    inline auto xproperty<T, O>::operator()(Arg&& arg, Args&&... args) && -> owner_type
     {
-        m_value = value_type(std::forward<Arg>(arg), std::forward<Args>(args)...);
+        value_type proposal(std::forward<Arg>(arg), std::forward<Args>(args)...);
+        initialize(proposal);
         return std::move(*owner());
     }
 
 #ifdef _MSC_VER
     template <class T, class O>
-    inline auto xproperty<T, O>::operator()(const value_type& arg) const & noexcept -> owner_type
+    inline auto xproperty<T, O>::operator()(const value_type& arg) const & -> owner_type
     {
         auto athis = const_cast<xproperty<T, O>*>(this);
-        athis->m_value = arg;
+        value_type proposal(arg);
+        athis->initialize(proposal);
         return std::move(*(athis->owner()));
     }
 
     template <class T, class O>
-    inline auto xproperty<T, O>::operator()(value_type&& arg) const & noexcept -> owner_type
+    inline auto xproperty<T, O>::operator()(value_type&& arg) const & -> owner_type
     {
         auto athis = const_cast<xproperty<T, O>*>(this);
-        athis->m_value = std::move(arg);
+        athis->initialize(arg);
         return std::move(*(athis->owner()));
     }
 
     template <class T, class O>
     template <class Arg, class... Args>
-    inline auto xproperty<T, O>::operator()(Arg&& arg, Args&&... args) const & noexcept -> owner_type
+    inline auto xproperty<T, O>::operator()(Arg&& arg, Args&&... args) const & -> owner_type
     {
         auto athis = const_cast<xproperty<T, O>*>(this);
-        athis->m_value = value_type(std::forward<Arg>(arg), std::forward<Args>(args)...);
+        value_type proposal(std::forward<Arg>(arg), std::forward<Args>(args)...);
+        athis->initialize(proposal);
         return std::move(*(athis->owner()));
     }
 #endif // _MSC_VER
@@ -237,12 +346,43 @@ namespace xp
     template <class V>
     inline auto xproperty<T, O>::operator=(V&& value) -> reference
     {
-        m_value = owner()->template invoke_validators<T>(m_name, std::forward<V>(value));
-        owner()->notify(m_name, m_value);
-        owner()->invoke_observers(m_name);
+        value_type proposal(std::forward<V>(value));
+        detail::xassign_outcome outcome = assign(proposal);
+        if (!outcome.m_validation)
+        {
+            throw xvalidation_error(outcome.m_validation.reason());
+        }
+        if (!outcome.m_link_validation)
+        {
+            throw xvalidation_error(outcome.m_link_validation.reason());
+        }
         return m_value;
     }
 
+    /**
+     * Assigns the specified value to the property unless a validator rejects it.
+     *
+     * Rejections reported through an xvalidation do not throw; the returned
+     * result then holds the reason of the rejection and the property keeps its
+     * value. Exceptions thrown by validators are propagated.
+     *
+     * Linked properties are assigned with try_assign as well. If one of them
+     * rejects the new value, the property keeps it and the returned result
+     * holds both the new value and the rejection.
+     */
+    template <class T, class O>
+    template <class V>
+    inline auto xproperty<T, O>::try_assign(V&& value) -> xassign_result<value_type>
+    {
+        value_type proposal(std::forward<V>(value));
+        detail::xassign_outcome outcome = assign(proposal);
+        if (!outcome.m_validation)
+        {
+            return xassign_result<value_type>(outcome.m_validation);
+        }
+        return xassign_result<value_type>(m_value, outcome.m_link_validation ? outcome.m_validation : outcome.m_link_validation);
+    }
+
     template <class T, class O>
     inline auto xproperty<T, O>::owner() noexcept -> owner_type*
     {
@@ -250,6 +390,63 @@ namespace xp
             reinterpret_cast<char*>(this) - m_offset
         );
     }
+
+    // Not a template on the proposed type, so that a single instance per
+    // property type is generated whatever the assigned types.
+    template <class T, class O>
+    inline detail::xassign_outcome xproperty<T, O>::assign(value_type& proposal)
+    {
+        detail::emit_assign_type emit = nullptr;
+        if constexpr (is_xobservable_container<value_type>::value)
+        {
+            emit = &emit_assign;
+        }
+        return owner()->assign_value(m_name, typeid(value_type), &m_value, &proposal,
+                                     &detail::move_assign<value_type>, emit);
+    }
+
+    // Assignment of an owner under construction: the validators are invoked,
+    // the observers are not.
+    template <class T, class O>
+    inline void xproperty<T, O>::initialize(value_type& proposal)
+    {
+        xvalidation validation = owner()->initialize_value(m_name, typeid(value_type), &m_value, &proposal,
+                                                           &detail::move_assign<value_type>);
+        if (!validation)
+        {
+            throw xvalidation_error(validation.reason());
+        }
+    }
+
+    template <class T, class O>
+    inline void xproperty<T, O>::bind_value() noexcept
+    {
+        if constexpr (is_xobservable_container<value_type>::value)
+        {
+            using event_type = typename value_type::event_type;
+            m_value.m_binding.bind(owner(), m_name, [](void* owner, const char* name, const event_type& event)
+            {
+                auto* o = static_cast<owner_type*>(owner);
+                o->notify(name, typeid(value_type), nullptr, &event.container);
+                o->invoke_change_observers(name, typeid(value_type), &event);
+                xvalidation validation = o->invoke_observers(name);
+                if (!validation)
+                {
+                    throw xvalidation_error(validation.reason());
+                }
+            });
+        }
+    }
+
+    template <class T, class O>
+    inline void xproperty<T, O>::emit_assign(void* owner, const char* name, const void* value)
+    {
+        if constexpr (is_xobservable_container<value_type>::value)
+        {
+            auto event = static_cast<const value_type*>(value)->assign_event();
+            static_cast<owner_type*>(owner)->invoke_change_observers(name, typeid(value_type), &event);
+        }
+    }
 }
 
 #endif
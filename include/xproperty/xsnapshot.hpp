@@ -0,0 +1,116 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XPROPERTY_SNAPSHOT_HPP
+#define XPROPERTY_SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace xp
+{
+    template <class D>
+    class xobserved;
+
+    namespace detail
+    {
+        template <class D, class M>
+        using snapshot_value_t = typename std::decay_t<decltype(std::declval<const D&>().*std::declval<M>())>::value_type;
+
+        template <class T, class U = T, class = void>
+        struct is_equality_comparable : std::false_type
+        {
+        };
+
+        template <class T, class U>
+        struct is_equality_comparable<T, U, std::void_t<decltype(std::declval<const T&>() == std::declval<const U&>())>>
+            : std::true_type
+        {
+        };
+    }
+
+    /*************************
+     * xsnapshot declaration *
+     *************************/
+
+    // Values of a fixed set of properties of an xobserved object, created with
+    // xobserved::snapshot. A snapshot does not hold the validators and
+    // observers of the object, and its size is known at compile time.
+
+    template <class D, class... M>
+    class xsnapshot
+    {
+        static_assert(sizeof...(M) > 0, "the properties to capture must be specified");
+
+    public:
+
+        using owner_type = D;
+        using value_types = std::tuple<detail::snapshot_value_t<D, M>...>;
+
+        static constexpr std::size_t size = sizeof...(M);
+
+        xsnapshot(const owner_type& owner, M... members);
+
+        template <std::size_t I>
+        const std::tuple_element_t<I, value_types>& get() const noexcept;
+
+    private:
+
+        template <std::size_t... I>
+        void capture(const owner_type& owner, std::index_sequence<I...>);
+
+        std::tuple<M...> m_members;
+        value_types m_values;
+
+        friend class xobserved<D>;
+    };
+
+    /****************************
+     * xsnapshot implementation *
+     ****************************/
+
+    template <class D, class... M>
+    inline xsnapshot<D, M...>::xsnapshot(const owner_type& owner, M... members)
+        : m_members(members...)
+        , m_values()
+    {
+        capture(owner, std::index_sequence_for<M...>());
+    }
+
+    template <class D, class... M>
+    template <std::size_t I>
+    inline auto xsnapshot<D, M...>::get() const noexcept -> const std::tuple_element_t<I, value_types>&
+    {
+        return std::get<I>(m_values);
+    }
+
+    template <class D, class... M>
+    template <std::size_t... I>
+    inline void xsnapshot<D, M...>::capture(const owner_type& owner, std::index_sequence<I...>)
+    {
+        auto capture_value = [&owner](auto member, auto& value)
+        {
+            using value_type = std::decay_t<decltype(value)>;
+            const value_type& current = (owner.*member)();
+            if constexpr (std::is_trivially_copyable<value_type>::value)
+            {
+                std::memcpy(&value, &current, sizeof(value_type));
+            }
+            else
+            {
+                value = current;
+            }
+        };
+        (capture_value(std::get<I>(m_members), std::get<I>(m_values)), ...);
+    }
+}
+
+#endif
@@ -0,0 +1,234 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XPROPERTY_VALIDATION_HPP
+#define XPROPERTY_VALIDATION_HPP
+
+#include <stdexcept>
+#include <type_traits>
+
+namespace xp
+{
+
+    /***************************
+     * xvalidation declaration *
+     ***************************/
+
+    enum class xvalidation_status
+    {
+        accept,
+        coerce,
+        reject
+    };
+
+    // Outcome of a validator. Validators returning an xvalidation can reject a
+    // proposal without throwing. The reason of a rejection is not copied and
+    // must outlive the validation, typically a string literal.
+
+    class xvalidation
+    {
+    public:
+
+        static constexpr xvalidation accept() noexcept;
+        static constexpr xvalidation coerce() noexcept;
+        static constexpr xvalidation reject(const char* reason) noexcept;
+
+        constexpr xvalidation_status status() const noexcept;
+        constexpr const char* reason() const noexcept;
+
+        constexpr bool accepted() const noexcept;
+        constexpr explicit operator bool() const noexcept;
+
+    private:
+
+        constexpr xvalidation(xvalidation_status status, const char* reason) noexcept;
+
+        xvalidation_status m_status;
+        const char* m_reason;
+    };
+
+    /*********************************
+     * xvalidation_error declaration *
+     *********************************/
+
+    // Thrown by the assignment operator of xproperty when a validator rejects
+    // the proposed value through an xvalidation.
+
+    class xvalidation_error : public std::runtime_error
+    {
+    public:
+
+        explicit xvalidation_error(const char* reason);
+    };
+
+    /******************************
+     * xassign_result declaration *
+     ******************************/
+
+    // Expected-like result of xproperty::try_assign: holds a reference to the
+    // new value of the property, or the reason of the rejection. When a linked
+    // property rejects the new value, the result holds both the new value and
+    // the rejection of the link.
+
+    template <class T>
+    class xassign_result
+    {
+    public:
+
+        using value_type = T;
+        using const_reference = const T&;
+
+        xassign_result(const_reference value, xvalidation validation) noexcept;
+        explicit xassign_result(xvalidation validation) noexcept;
+
+        bool has_value() const noexcept;
+        explicit operator bool() const noexcept;
+
+        const_reference value() const;
+        const_reference operator*() const noexcept;
+
+        xvalidation_status status() const noexcept;
+        const char* error() const noexcept;
+        xvalidation validation() const noexcept;
+
+    private:
+
+        const value_type* p_value;
+        xvalidation m_validation;
+    };
+
+    /******************************
+     * xvalidation implementation *
+     ******************************/
+
+    constexpr xvalidation::xvalidation(xvalidation_status status, const char* reason) noexcept
+        : m_status(status)
+        , m_reason(reason)
+    {
+    }
+
+    constexpr xvalidation xvalidation::accept() noexcept
+    {
+        return xvalidation(xvalidation_status::accept, nullptr);
+    }
+
+    constexpr xvalidation xvalidation::coerce() noexcept
+    {
+        return xvalidation(xvalidation_status::coerce, nullptr);
+    }
+
+    constexpr xvalidation xvalidation::reject(const char* reason) noexcept
+    {
+        return xvalidation(xvalidation_status::reject, reason);
+    }
+
+    constexpr xvalidation_status xvalidation::status() const noexcept
+    {
+        return m_status;
+    }
+
+    constexpr const char* xvalidation::reason() const noexcept
+    {
+        return m_reason;
+    }
+
+    constexpr bool xvalidation::accepted() const noexcept
+    {
+        return m_status != xvalidation_status::reject;
+    }
+
+    constexpr xvalidation::operator bool() const noexcept
+    {
+        return accepted();
+    }
+
+    /************************************
+     * xvalidation_error implementation *
+     ************************************/
+
+    inline xvalidation_error::xvalidation_error(const char* reason)
+        : std::runtime_error(reason != nullptr ? reason : "Invalid proposal.")
+    {
+    }
+
+    /*********************************
+     * xassign_result implementation *
+     *********************************/
+
+    template <class T>
+    inline xassign_result<T>::xassign_result(const_reference value, xvalidation validation) noexcept
+        : p_value(&value)
+        , m_validation(validation)
+    {
+    }
+
+    template <class T>
+    inline xassign_result<T>::xassign_result(xvalidation validation) noexcept
+        : p_value(nullptr)
+        , m_validation(validation)
+    {
+    }
+
+    template <class T>
+    inline bool xassign_result<T>::has_value() const noexcept
+    {
+        return p_value != nullptr;
+    }
+
+    template <class T>
+    inline xassign_result<T>::operator bool() const noexcept
+    {
+        return has_value();
+    }
+
+    /**
+     * Returns the new value of the property.
+     * @throw xvalidation_error if the proposal was rejected.
+     **/
+    template <class T>
+    inline auto xassign_result<T>::value() const -> const_reference
+    {
+        if (p_value == nullptr)
+        {
+            throw xvalidation_error(m_validation.reason());
+        }
+        return *p_value;
+    }
+
+    template <class T>
+    inline auto xassign_result<T>::operator*() const noexcept -> const_reference
+    {
+        return *p_value;
+    }
+
+    template <class T>
+    inline xvalidation_status xassign_result<T>::status() const noexcept
+    {
+        return m_validation.status();
+    }
+
+    template <class T>
+    inline const char* xassign_result<T>::error() const noexcept
+    {
+        return m_validation.reason();
+    }
+
+    template <class T>
+    inline xvalidation xassign_result<T>::validation() const noexcept
+    {
+        return m_validation;
+    }
+
+    namespace detail
+    {
+        template <class F, class D, class V>
+        using is_status_validator = std::is_same<std::invoke_result_t<F, D&, V&>, xvalidation>;
+    }
+}
+
+#endif
@@ -0,0 +1,24 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "test_module.hpp"
+
+void validate_in_module(Moduled& m)
+{
+    XVALIDATE(m, bar, [](Moduled&, double& proposal) {
+        if (proposal < 0.0)
+        {
+            proposal = 0.0;
+        }
+    });
+}
+
+void assign_in_module(Moduled& m, double value)
+{
+    m.bar = value;
+}
@@ -0,0 +1,37 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef TEST_MODULE_HPP
+#define TEST_MODULE_HPP
+
+#include "xproperty/xobserved.hpp"
+
+// Functions of a shared library built with hidden visibility, to register
+// callbacks and assign properties in another module than the tests.
+
+#if defined(_WIN32)
+#  if defined(XPROPERTY_TEST_MODULE_EXPORTS)
+#    define XPROPERTY_TEST_MODULE_API __declspec(dllexport)
+#  else
+#    define XPROPERTY_TEST_MODULE_API __declspec(dllimport)
+#  endif
+#else
+#  define XPROPERTY_TEST_MODULE_API __attribute__((visibility("default")))
+#endif
+
+struct Moduled : public xp::xobserved<Moduled>
+{
+    XPROPERTY(double, Moduled, bar);
+};
+
+// Registers a validator clamping bar to non-negative values
+XPROPERTY_TEST_MODULE_API void validate_in_module(Moduled& m);
+
+XPROPERTY_TEST_MODULE_API void assign_in_module(Moduled& m, double value);
+
+#endif
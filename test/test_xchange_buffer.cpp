@@ -0,0 +1,173 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "doctest/doctest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "xproperty/xobserved.hpp"
+#include "xproperty/xchange_buffer.hpp"
+
+struct Recorded : public xp::xobserved<Recorded>
+{
+    XPROPERTY(double, Recorded, bar);
+    XPROPERTY(double, Recorded, baz);
+};
+
+TEST_SUITE("xchange_buffer")
+{
+    TEST_CASE("indices")
+    {
+        xp::xchange_buffer<> buffer(8);
+        Recorded r1, r2;
+        XRECORD(r1, bar, buffer);
+        XRECORD(r2, bar, buffer);
+
+        r1.bar = 1.0;
+        r2.bar = 2.0;
+        r1.baz = 3.0;
+        r1.bar = 4.0;
+        REQUIRE_EQ(size_t(3), buffer.size());
+
+        std::vector<std::size_t> indices;
+        std::vector<std::uint64_t> sequences;
+        std::size_t count = buffer.drain([&](const auto& record) {
+            indices.push_back(record.index);
+            sequences.push_back(record.sequence);
+        });
+        REQUIRE_EQ(size_t(3), count);
+        REQUIRE_EQ(std::vector<std::size_t>({0, 1, 0}), indices);
+        REQUIRE_EQ(std::vector<std::uint64_t>({0, 1, 2}), sequences);
+        REQUIRE_EQ(std::string("bar"), std::string(buffer.name(1)));
+        REQUIRE_EQ(static_cast<const void*>(&r1), buffer.key(0));
+        REQUIRE_EQ(static_cast<const void*>(&r2), buffer.key(1));
+        REQUIRE(buffer.empty());
+
+        XUNRECORD(r1, bar);
+        r1.bar = 5.0;
+        REQUIRE(buffer.empty());
+    }
+
+    TEST_CASE("keys")
+    {
+        xp::xchange_buffer<> buffer(8);
+        static const char widget_key[] = "widget";
+        Recorded r1;
+        XRECORD_KEY(r1, bar, buffer, widget_key);
+
+        // Copies do not record, moves keep recording with the same key
+        Recorded r2 = r1;
+        r2.bar = 1.0;
+        REQUIRE(buffer.empty());
+        Recorded r3 = std::move(r1);
+        r3.bar = 2.0;
+
+        std::vector<const void*> keys;
+        buffer.drain([&](const auto& record) {
+            keys.push_back(buffer.key(record.index));
+        });
+        REQUIRE_EQ(std::vector<const void*>({widget_key}), keys);
+
+        // Assigning a copy stops recording
+        r3 = r2;
+        r3.bar = 3.0;
+        REQUIRE(buffer.empty());
+    }
+
+    TEST_CASE("values")
+    {
+        xp::xchange_buffer<double> buffer(4);
+        Recorded r;
+        r.bar = 1.0;
+        XRECORD(r, bar, buffer);
+
+        r.bar = 2.0;
+        r.bar = 3.0;
+
+        std::vector<double> old_values, new_values;
+        buffer.drain([&](const auto& record) {
+            old_values.push_back(record.old_value);
+            new_values.push_back(record.new_value);
+        });
+        REQUIRE_EQ(std::vector<double>({1.0, 2.0}), old_values);
+        REQUIRE_EQ(std::vector<double>({2.0, 3.0}), new_values);
+    }
+
+    TEST_CASE("reentrant_drain")
+    {
+        xp::xchange_buffer<double> buffer(4);
+        Recorded r;
+        XRECORD(r, bar, buffer);
+
+        r.bar = 1.0;
+        std::vector<std::string> names;
+        buffer.drain([&](const auto& record) {
+            names.push_back(buffer.name(record.index));
+            r.bar = record.new_value + 1.0;
+        });
+        REQUIRE_EQ(std::vector<std::string>({"bar"}), names);
+        REQUIRE_EQ(size_t(1), buffer.size());
+    }
+
+    TEST_CASE("overflow_report")
+    {
+        xp::xchange_buffer<double> buffer(2);
+        Recorded r;
+        XRECORD(r, bar, buffer);
+
+        r.bar = 1.0;
+        r.bar = 2.0;
+        r.bar = 3.0;
+        REQUIRE_EQ(size_t(1), buffer.dropped());
+
+        // Drops consume a sequence number
+        REQUIRE_EQ(size_t(1), buffer.drain([](const auto&) {}, 1u));
+        r.bar = 4.0;
+        std::vector<std::uint64_t> sequences;
+        buffer.drain([&](const auto& record) {
+            sequences.push_back(record.sequence);
+        });
+        REQUIRE_EQ(std::vector<std::uint64_t>({1, 3}), sequences);
+    }
+
+    TEST_CASE("overflow_coalesce")
+    {
+        xp::xchange_buffer<double> buffer(2, xp::xoverflow_policy::coalesce);
+        Recorded r;
+        XRECORD(r, bar, buffer);
+        XRECORD(r, baz, buffer);
+
+        r.bar = 1.0;
+        r.baz = 2.0;
+        r.bar = 3.0;
+        r.bar = 4.0;
+        REQUIRE_EQ(size_t(0), buffer.dropped());
+
+        std::vector<double> old_values, new_values;
+        std::vector<std::uint64_t> sequences;
+        buffer.drain([&](const auto& record) {
+            old_values.push_back(record.old_value);
+            new_values.push_back(record.new_value);
+            sequences.push_back(record.sequence);
+        });
+        REQUIRE_EQ(std::vector<double>({0.0, 0.0}), old_values);
+        REQUIRE_EQ(std::vector<double>({4.0, 2.0}), new_values);
+        // Coalesced changes keep the sequence number of their record
+        REQUIRE_EQ(std::vector<std::uint64_t>({0, 1}), sequences);
+
+        r.baz = 5.0;
+        buffer.drain([&](const auto& record) {
+            sequences.push_back(record.sequence);
+        });
+        REQUIRE_EQ(std::vector<std::uint64_t>({0, 1, 2}), sequences);
+    }
+}
@@ -0,0 +1,158 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "doctest/doctest.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "test_utils.hpp"
+
+#include "xproperty/xobserved.hpp"
+#include "xproperty/xcontainers.hpp"
+
+using counts_type = xp::xobservable_map<std::string, int>;
+
+struct Listing : public xp::xobserved<Listing>
+{
+    XPROPERTY(xp::xobservable_vector<std::string>, Listing, items, {"a"});
+    XPROPERTY(counts_type, Listing, counts);
+};
+
+TEST_SUITE("xcontainers")
+{
+    TEST_CASE("vector_events")
+    {
+        xp::reset_counter();
+        Listing l;
+        l.items().push_back("b");
+
+        std::vector<xp::xcontainer_op> ops;
+        std::vector<std::size_t> indices;
+        XOBSERVE_CHANGES(l, items, [&](Listing&, const auto& event) {
+            ops.push_back(event.op);
+            indices.push_back(event.index);
+        });
+        XOBSERVE(l, items, [](Listing&) {
+            ++xp::get_observe_count();
+        });
+
+        l.items().push_back("c");
+        l.items().insert(l.items().begin(), "z");
+        l.items().set(1, "A");
+        l.items().erase(l.items().begin() + 2);
+        REQUIRE_EQ(std::vector<std::string>({"z", "A", "c"}), l.items().value());
+
+        REQUIRE_EQ(size_t(4), ops.size());
+        REQUIRE(ops[0] == xp::xcontainer_op::insert);
+        REQUIRE_EQ(size_t(2), indices[0]);
+        REQUIRE(ops[1] == xp::xcontainer_op::insert);
+        REQUIRE_EQ(size_t(0), indices[1]);
+        REQUIRE(ops[2] == xp::xcontainer_op::replace);
+        REQUIRE_EQ(size_t(1), indices[2]);
+        REQUIRE(ops[3] == xp::xcontainer_op::erase);
+        REQUIRE_EQ(size_t(2), indices[3]);
+        REQUIRE_EQ(size_t(4), xp::get_observe_count());
+
+        // Whole assignment emits a single assign event
+        l.items = xp::xobservable_vector<std::string>({"x", "y"});
+        REQUIRE_EQ(size_t(5), ops.size());
+        REQUIRE(ops.back() == xp::xcontainer_op::assign);
+        REQUIRE_EQ(size_t(0), indices.back());
+        REQUIRE_EQ(size_t(5), xp::get_observe_count());
+        l.items().clear();
+        REQUIRE(ops.back() == xp::xcontainer_op::clear);
+    }
+
+    TEST_CASE("restore_events")
+    {
+        Listing l;
+        auto snapshot = l.snapshot(&Listing::items, &Listing::counts);
+        l.items().push_back("b");
+
+        std::vector<xp::xcontainer_op> ops;
+        std::vector<std::size_t> counts;
+        XOBSERVE_CHANGES(l, items, [&](Listing&, const auto& event) {
+            ops.push_back(event.op);
+            counts.push_back(event.count);
+        });
+        XOBSERVE_CHANGES(l, counts, [&](Listing&, const auto& event) {
+            ops.push_back(event.op);
+        });
+
+        l.restore(snapshot);
+        REQUIRE_EQ(std::vector<std::string>({"a"}), l.items().value());
+        REQUIRE_EQ(size_t(1), ops.size());
+        REQUIRE(ops[0] == xp::xcontainer_op::assign);
+        REQUIRE_EQ(size_t(1), counts[0]);
+
+        l.counts().assign({{"a", 1}});
+        REQUIRE_EQ(size_t(2), ops.size());
+        REQUIRE(ops[1] == xp::xcontainer_op::assign);
+        REQUIRE_EQ(1, l.counts().at("a"));
+    }
+
+    TEST_CASE("map_events")
+    {
+        Listing l;
+
+        std::vector<xp::xcontainer_op> ops;
+        std::vector<std::string> keys;
+        XOBSERVE_CHANGES(l, counts, [&](Listing&, const auto& event) {
+            ops.push_back(event.op);
+            keys.push_back(event.key != nullptr ? *event.key : std::string());
+        });
+
+        l.counts().insert_or_assign("a", 1);
+        l.counts().insert_or_assign("a", 2);
+        l.counts().emplace("b", 3);
+        l.counts().erase("a");
+        l.counts().erase("missing");
+        REQUIRE_EQ(3, l.counts().at("b"));
+        REQUIRE_EQ(size_t(1), l.counts().size());
+
+        // The key refers to the erased element
+        l.counts().emplace("c", 4);
+        REQUIRE_EQ(size_t(1), l.counts().erase(l.counts().begin()->first));
+        REQUIRE_EQ(4, l.counts().at("c"));
+
+        REQUIRE_EQ(size_t(6), ops.size());
+        REQUIRE(ops[0] == xp::xcontainer_op::insert);
+        REQUIRE(ops[1] == xp::xcontainer_op::replace);
+        REQUIRE(ops[2] == xp::xcontainer_op::insert);
+        REQUIRE(ops[3] == xp::xcontainer_op::erase);
+        REQUIRE(ops[4] == xp::xcontainer_op::insert);
+        REQUIRE(ops[5] == xp::xcontainer_op::erase);
+        REQUIRE_EQ(std::vector<std::string>({"a", "a", "b", "a", "c", "b"}), keys);
+    }
+
+    TEST_CASE("copy_rebinds")
+    {
+        xp::reset_counter();
+        Listing l1;
+        l1.items().push_back("b");
+        XOBSERVE(l1, items, [](Listing&) {
+            ++xp::get_observe_count();
+        });
+
+        // Copies of the owner are bound to the copy
+        Listing l2 = l1;
+        l2.items().push_back("c");
+        REQUIRE_EQ(size_t(1), xp::get_observe_count());
+        REQUIRE_EQ(size_t(2), l1.items().size());
+
+        // Standalone copies of a container are not bound
+        auto items = l1.items();
+        items.push_back("c");
+        REQUIRE_EQ(size_t(1), xp::get_observe_count());
+
+        l1.items().push_back("d");
+        REQUIRE_EQ(size_t(2), xp::get_observe_count());
+    }
+}
@@ -11,6 +11,7 @@
 #include <iostream>
 
 #include "xproperty/xobserved.hpp"
+#include "xproperty/xcontainers.hpp"
 #include "xproperty/xjson.hpp"
 
 struct Baz : xp::xobserved<Baz>
@@ -18,6 +19,14 @@ struct Baz : xp::xobserved<Baz>
     XPROPERTY(double, Baz, bar);
 };
 
+using int_map = xp::xobservable_map<std::string, int>;
+
+struct Spliced : xp::xobserved<Spliced>
+{
+    XPROPERTY(xp::xobservable_vector<int>, Spliced, values);
+    XPROPERTY(int_map, Spliced, counts);
+};
+
 TEST_SUITE("xproperty_json")
 {
     TEST_CASE("json")
@@ -29,5 +38,41 @@ TEST_SUITE("xproperty_json")
         double t = j;
         REQUIRE_EQ(2.0, t);
     }
-}
 
+    TEST_CASE("container_patches")
+    {
+        Spliced s;
+        nlohmann::json patch;
+        XOBSERVE_CHANGES(s, values, [&](Spliced&, const auto& event) {
+            patch = event;
+        });
+        XOBSERVE_CHANGES(s, counts, [&](Spliced&, const auto& event) {
+            patch = event;
+        });
+
+        s.values().push_back(1);
+        REQUIRE_EQ(nlohmann::json::parse(R"([{"op": "add", "path": "/0", "value": 1}])"), patch);
+        s.values().insert(s.values().begin(), {2, 3});
+        REQUIRE_EQ(nlohmann::json::parse(R"([{"op": "add", "path": "/0", "value": 2}, {"op": "add", "path": "/1", "value": 3}])"), patch);
+        s.values().set(2, 4);
+        REQUIRE_EQ(nlohmann::json::parse(R"([{"op": "replace", "path": "/2", "value": 4}])"), patch);
+        s.values().erase(s.values().begin());
+        REQUIRE_EQ(nlohmann::json::parse(R"([{"op": "remove", "path": "/0"}])"), patch);
+
+        nlohmann::json j = s.values;
+        REQUIRE_EQ(nlohmann::json::parse("[3, 4]"), j);
+
+        s.counts().insert_or_assign("a/b", 1);
+        REQUIRE_EQ(nlohmann::json::parse(R"([{"op": "add", "path": "/a~1b", "value": 1}])"), patch);
+        s.counts().erase("a/b");
+        REQUIRE_EQ(nlohmann::json::parse(R"([{"op": "remove", "path": "/a~1b"}])"), patch);
+
+        j = nlohmann::json::parse(R"({"x": 1})");
+        j.get_to(s.counts());
+        REQUIRE_EQ(1, s.counts().at("x"));
+        REQUIRE_EQ(nlohmann::json::parse(R"([{"op": "replace", "path": "", "value": {"x": 1}}])"), patch);
+
+        s.values = xp::xobservable_vector<int>({5});
+        REQUIRE_EQ(nlohmann::json::parse(R"([{"op": "replace", "path": "", "value": [5]}])"), patch);
+    }
+}
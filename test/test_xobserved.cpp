@@ -9,9 +9,14 @@
 #include "doctest/doctest.h"
 
 #include <cstddef>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <utility>
 
+#include "test_module.hpp"
 #include "test_utils.hpp"
 
 #include "xproperty/xobserved.hpp"
@@ -72,6 +77,57 @@ TEST_SUITE("xobserved")
         REQUIRE_EQ(size_t(3), xp::get_validate_count());
     }
 
+    TEST_CASE("status_validation")
+    {
+        xp::reset_counter();
+        Observed foo;
+
+        XOBSERVE(foo, bar, [](Observed&) {
+            ++xp::get_observe_count();
+        });
+
+        // Validator rejecting negative values and coercing values above 10
+        XVALIDATE(foo, bar, [](Observed&, double& proposal) {
+            ++xp::get_validate_count();
+            if (proposal < 0.0)
+            {
+                return xp::xvalidation::reject("Only non-negative values are valid.");
+            }
+            if (proposal > 10.0)
+            {
+                proposal = 10.0;
+                return xp::xvalidation::coerce();
+            }
+            return xp::xvalidation::accept();
+        });
+
+        auto res = foo.bar.try_assign(1.0);
+        REQUIRE(res.has_value());
+        REQUIRE_EQ(1.0, *res);
+        REQUIRE(res.status() == xp::xvalidation_status::accept);
+        REQUIRE_EQ(size_t(1), xp::get_observe_count());
+
+        res = foo.bar.try_assign(-1.0);
+        REQUIRE_FALSE(res.has_value());
+        REQUIRE(res.status() == xp::xvalidation_status::reject);
+        REQUIRE_EQ(std::string("Only non-negative values are valid."), std::string(res.error()));
+        REQUIRE_THROWS_AS(res.value(), xp::xvalidation_error);
+        REQUIRE_EQ(1.0, double(foo.bar));
+        REQUIRE_EQ(size_t(1), xp::get_observe_count());
+
+        res = foo.bar.try_assign(12.0);
+        REQUIRE(res.has_value());
+        REQUIRE(res.status() == xp::xvalidation_status::coerce);
+        REQUIRE_EQ(10.0, double(foo.bar));
+        REQUIRE_EQ(size_t(2), xp::get_observe_count());
+
+        // The assignment operator throws on rejection
+        REQUIRE_THROWS_AS({ foo.bar = -1.0; }, xp::xvalidation_error);
+        REQUIRE_EQ(10.0, double(foo.bar));
+        REQUIRE_EQ(size_t(2), xp::get_observe_count());
+        REQUIRE_EQ(size_t(4), xp::get_validate_count());
+    }
+
     TEST_CASE("links")
     {
         xp::reset_counter();
@@ -84,6 +140,223 @@ TEST_SUITE("xobserved")
         REQUIRE_EQ(2.0, double(target.baz));
     }
 
+    TEST_CASE("bidirectional_links")
+    {
+        xp::reset_counter();
+        Observed source, target;
+
+        XOBSERVE(source, bar, [](Observed&) {
+            ++xp::get_observe_count();
+        });
+
+        source.bar = 1.0;
+        XLINK(source, bar, target, baz);
+        REQUIRE_EQ(1.0, double(target.baz));
+        target.baz = 2.0;
+        REQUIRE_EQ(2.0, double(source.bar));
+        source.bar = 3.0;
+        REQUIRE_EQ(3.0, double(target.baz));
+        REQUIRE_EQ(size_t(3), xp::get_observe_count());
+
+        XUNLINK(source, bar, target, baz);
+        REQUIRE_EQ(size_t(0), source.link_count());
+        source.bar = 4.0;
+        REQUIRE_EQ(3.0, double(target.baz));
+    }
+
+    TEST_CASE("bidirectional_link_coercion")
+    {
+        xp::reset_counter();
+        Observed source, target;
+        XLINK(source, bar, target, baz);
+        XVALIDATE(target, baz, [](Observed&, double& proposal) {
+            if (proposal > 3.0)
+            {
+                proposal = 3.0;
+            }
+        });
+        XOBSERVE(source, bar, [](Observed&) {
+            ++xp::get_observe_count();
+        });
+
+        // The coerced value is assigned back to the source once
+        source.bar = 5.0;
+        REQUIRE_EQ(3.0, double(target.baz));
+        REQUIRE_EQ(3.0, double(source.bar));
+        REQUIRE_EQ(size_t(2), xp::get_observe_count());
+
+        source.bar = 2.0;
+        REQUIRE_EQ(2.0, double(target.baz));
+        REQUIRE_EQ(size_t(3), xp::get_observe_count());
+
+        target.baz = 4.0;
+        REQUIRE_EQ(3.0, double(source.bar));
+        REQUIRE_EQ(size_t(4), xp::get_observe_count());
+    }
+
+    TEST_CASE("link_lifetime")
+    {
+        Observed source;
+        {
+            Observed target;
+            XDLINK(source, bar, target, baz);
+            REQUIRE_EQ(size_t(1), source.link_count());
+
+            // Copies do not inherit links
+            Observed copy = target;
+            REQUIRE_EQ(size_t(0), copy.link_count());
+        }
+        REQUIRE_EQ(size_t(0), source.link_count());
+        source.bar = 1.0;
+
+        Observed target;
+        {
+            Observed other;
+            XDLINK(other, bar, target, baz);
+            XDLINK(source, bar, target, baz);
+            REQUIRE_EQ(size_t(2), target.link_count());
+        }
+        REQUIRE_EQ(size_t(1), target.link_count());
+        source.bar = 2.0;
+        REQUIRE_EQ(2.0, double(target.baz));
+
+        // Moving an endpoint removes its links
+        Observed moved = std::move(target);
+        REQUIRE_EQ(size_t(0), source.link_count());
+        REQUIRE_EQ(size_t(0), moved.link_count());
+    }
+
+    TEST_CASE("unlink_during_propagation")
+    {
+        Observed source, target;
+        XDLINK(source, bar, target, bar);
+        XOBSERVE(target, bar, [&](Observed&) {
+            XUNLINK(source, bar, target, bar);
+        });
+        source.bar = 1.0;
+        REQUIRE_EQ(1.0, double(target.bar));
+        REQUIRE_EQ(size_t(0), source.link_count());
+        source.bar = 2.0;
+        REQUIRE_EQ(1.0, double(target.bar));
+
+        // Destroying the next target of the propagation
+        auto other = std::make_unique<Observed>();
+        Observed& next = *other;
+        XDLINK(source, baz, next, baz);
+        XDLINK(source, baz, target, baz);
+        XOBSERVE(target, baz, [&](Observed&) {
+            other.reset();
+        });
+        source.baz = 3.0;
+        REQUIRE_EQ(3.0, double(target.baz));
+        REQUIRE(other == nullptr);
+        REQUIRE_EQ(size_t(1), source.link_count());
+        source.baz = 4.0;
+        REQUIRE_EQ(4.0, double(target.baz));
+    }
+
+    TEST_CASE("link_rejection")
+    {
+        Observed source, target;
+        XDLINK(source, bar, target, bar);
+        XVALIDATE(target, bar, [](Observed&, double& proposal) {
+            return proposal < 0.0 ? xp::xvalidation::reject("negative") : xp::xvalidation::accept();
+        });
+
+        // The source keeps its new value, the result reports the rejection
+        auto res = source.bar.try_assign(-1.0);
+        REQUIRE(res.has_value());
+        REQUIRE(res.status() == xp::xvalidation_status::reject);
+        REQUIRE_EQ(std::string("negative"), std::string(res.error()));
+        REQUIRE_EQ(-1.0, double(source.bar));
+        REQUIRE_EQ(0.0, double(target.bar));
+
+        REQUIRE(source.bar.try_assign(1.0).status() == xp::xvalidation_status::accept);
+        REQUIRE_EQ(1.0, double(target.bar));
+
+        REQUIRE_THROWS_AS({ source.bar = -2.0; }, xp::xvalidation_error);
+        REQUIRE_EQ(-2.0, double(source.bar));
+        REQUIRE_EQ(1.0, double(target.bar));
+    }
+
+    TEST_CASE("link_argument_names")
+    {
+        Observed s, t;
+        XDLINK(s, bar, t, bar);
+        XLINK(s, baz, t, baz);
+        s.bar = 1.0;
+        REQUIRE_EQ(1.0, double(t.bar));
+        t.baz = 2.0;
+        REQUIRE_EQ(2.0, double(s.baz));
+    }
+
+    TEST_CASE("callback_type_mismatch")
+    {
+        Observed foo;
+        XVALIDATE(foo, bar, [](Observed&, double&) {});
+        std::function<void(Observed&, int&)> validator = [](Observed&, int&) {};
+        REQUIRE_THROWS_AS(foo.validate<int>(foo.bar.name(), validator), std::invalid_argument);
+        foo.bar = 1.0;
+        REQUIRE_EQ(1.0, double(foo.bar));
+
+        // A mismatch registered first is detected at the assignment
+        foo.validate<int>(foo.baz.name(), validator);
+        REQUIRE_THROWS_AS({ foo.baz = 1.0; }, std::invalid_argument);
+        REQUIRE_EQ(0.0, double(foo.baz));
+    }
+
+    TEST_CASE("callbacks_across_modules")
+    {
+        Moduled m;
+        validate_in_module(m);
+        m.bar = -1.0;
+        REQUIRE_EQ(0.0, double(m.bar));
+
+        Moduled n;
+        XVALIDATE(n, bar, [](Moduled&, double& proposal) { proposal *= 2.0; });
+        assign_in_module(n, 1.0);
+        REQUIRE_EQ(2.0, double(n.bar));
+    }
+
+    struct Snapshotted : public xp::xobserved<Snapshotted>
+    {
+        XPROPERTY(double, Snapshotted, bar);
+        XPROPERTY(double, Snapshotted, baz);
+        XPROPERTY(std::string, Snapshotted, name);
+    };
+
+    TEST_CASE("snapshot")
+    {
+        Snapshotted foo;
+        foo.bar = 1.0;
+        foo.baz = 2.0;
+        foo.name = "foo";
+
+        std::size_t bar_count = 0, baz_count = 0, name_count = 0;
+        XOBSERVE(foo, bar, [&](Snapshotted&) { ++bar_count; });
+        XOBSERVE(foo, baz, [&](Snapshotted& f) {
+            // Observers see every restored value
+            REQUIRE_EQ(std::string("foo"), f.name());
+            ++baz_count;
+        });
+        XOBSERVE(foo, name, [&](Snapshotted&) { ++name_count; });
+
+        auto snapshot = foo.snapshot(&Snapshotted::bar, &Snapshotted::baz, &Snapshotted::name);
+        REQUIRE_EQ(2.0, snapshot.get<1>());
+
+        foo.baz = 3.0;
+        foo.name = "bar";
+        bar_count = baz_count = name_count = 0;
+
+        foo.restore(snapshot);
+        REQUIRE_EQ(1.0, double(foo.bar));
+        REQUIRE_EQ(2.0, double(foo.baz));
+        REQUIRE_EQ(std::string("foo"), foo.name());
+        REQUIRE_EQ(size_t(0), bar_count);
+        REQUIRE_EQ(size_t(1), baz_count);
+        REQUIRE_EQ(size_t(1), name_count);
+    }
+
     TEST_CASE("value_semantic")
     {
         Observed foo1, foo2;
@@ -89,6 +89,25 @@ TEST_SUITE("xproperty")
         REQUIRE_EQ(0.0, ro.bin());
     }
 
+    struct Rs : xp::xobserved<Rs>
+    {
+        XPROPERTY(double, Rs, bin, 1.0, [](double& i) {
+            return i < 0.0 ? xp::xvalidation::reject("negative") : xp::xvalidation::accept();
+        });
+    };
+
+    TEST_CASE("lambda_status_validation")
+    {
+        Rs rs;
+        auto res = rs.bin.try_assign(-1.0);
+        REQUIRE_FALSE(res);
+        REQUIRE_EQ(1.0, rs.bin());
+        REQUIRE_THROWS_AS({ rs.bin = -1.0; }, xp::xvalidation_error);
+        REQUIRE_EQ(1.0, rs.bin());
+        REQUIRE(rs.bin.try_assign(2.0));
+        REQUIRE_EQ(2.0, rs.bin());
+    }
+
     template <class T>
     struct DEBUG;
 
@@ -97,5 +116,65 @@ TEST_SUITE("xproperty")
         //DEBUG<decltype(Ro().bin)>::type t;
         auto ro = Ro().bin(0.0);
         REQUIRE_EQ(0.0, ro.bin());
+        auto clamped = Ro().bin(-1.0);
+        REQUIRE_EQ(0.0, clamped.bin());
+        REQUIRE_THROWS_AS(Rs().bin(-1.0), xp::xvalidation_error);
+    }
+
+    struct move_counter
+    {
+        static std::size_t moves;
+
+        move_counter() = default;
+        move_counter(const move_counter&) = default;
+        move_counter(move_counter&&) noexcept
+        {
+            ++moves;
+        }
+    };
+
+    std::size_t move_counter::moves = 0u;
+
+    struct Built : xp::xobserved<Built>
+    {
+        Built()
+        {
+            Built& self = *this;
+            XOBSERVE(self, first, [](Built& b) { ++b.notifications; });
+            XVALIDATE(self, second, [](Built& b, double& proposal) { ++b.validations; if (proposal < 0.0) proposal = 0.0; });
+        }
+
+        XPROPERTY(double, Built, first);
+        XPROPERTY(double, Built, second);
+        XPROPERTY(std::string, Built, third);
+
+        std::size_t notifications = 0u;
+        std::size_t validations = 0u;
+        move_counter counter;
+    };
+
+    TEST_CASE("builder")
+    {
+        move_counter::moves = 0u;
+        Built built = xp::xbuilder<Built>()
+            .set(&Built::first, 1.0)
+            .set(&Built::second, -1.0)
+            .set(&Built::third, 3u, 'a')
+            .build();
+        REQUIRE_EQ(1u, move_counter::moves);
+        REQUIRE_EQ(1.0, built.first());
+        REQUIRE_EQ(0.0, built.second());
+        REQUIRE_EQ(std::string("aaa"), built.third());
+        REQUIRE_EQ(1u, built.validations);
+        REQUIRE_EQ(0u, built.notifications);
+
+        built.first = 2.0;
+        REQUIRE_EQ(1u, built.notifications);
+
+        xp::xbuilder<Rs> builder;
+        REQUIRE_THROWS_AS(builder.set(&Rs::bin, -1.0), xp::xvalidation_error);
+        REQUIRE_EQ(1.0, builder.get().bin());
+        builder.set(&Rs::bin, 2.0);
+        REQUIRE_EQ(2.0, builder.get().bin());
     }
 }